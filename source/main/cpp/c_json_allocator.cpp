@@ -82,6 +82,16 @@ namespace ncore
             return ptr;
         }
 
+        char* JsonAllocator::Reserve(s64 size)
+        {
+            const s64 align  = sizeof(void*); // Pointer size alignment
+            const s64 offset = (this->m_Size + align - 1) & ~(align - 1);
+            if ((offset + size) > this->m_Capacity)
+                return nullptr;
+            this->m_Size = offset;
+            return this->m_Pointer + offset;
+        }
+
         void JsonAllocator::Commit(char* ptr)
         {
             ASSERT((ptr >= this->m_Pointer) && (ptr <= (this->m_Pointer + this->m_Capacity)));
@@ -0,0 +1,140 @@
+#include "ccore/c_target.h"
+#include "ccore/c_debug.h"
+#include "cbase/c_memory.h"
+#include "cjson/c_json_simd.h"
+#include "cjson/c_json_charclass.h"
+
+namespace ncore
+{
+    namespace njson
+    {
+        // clang-format off
+        const u8 g_JsonCharClass[256] = {
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x02, 0x08, 0x08, 0x00,
+            0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x20, 0x20, 0x20, 0x20, 0x28, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+            0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x02, 0x00, 0x02, 0x00, 0x00,
+            0x00, 0x20, 0x20, 0x20, 0x20, 0x28, 0x30, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x30, 0x20,
+            0x20, 0x20, 0x20, 0x20, 0x30, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x02, 0x00, 0x02, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        };
+        // clang-format on
+
+        char const* JsonFindStringSpecial(char const* str, char const* end)
+        {
+#if defined(CJSON_SIMD_AVX2)
+            __m256i const quote     = _mm256_set1_epi8('"');
+            __m256i const backslash = _mm256_set1_epi8('\\');
+            __m256i const control   = _mm256_set1_epi8(0x1F);
+            while ((end - str) >= 32)
+            {
+                __m256i const v       = _mm256_loadu_si256((__m256i const*)str);
+                __m256i const special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)), _mm256_cmpeq_epi8(_mm256_min_epu8(v, control), v));
+                u32 const     mask    = (u32)_mm256_movemask_epi8(special);
+                if (mask != 0)
+                    return str + JsonCountTrailingZeros64(mask);
+                str += 32;
+            }
+#elif defined(CJSON_SIMD_SSE2)
+            __m128i const quote     = _mm_set1_epi8('"');
+            __m128i const backslash = _mm_set1_epi8('\\');
+            __m128i const control   = _mm_set1_epi8(0x1F);
+            while ((end - str) >= 16)
+            {
+                __m128i const v       = _mm_loadu_si128((__m128i const*)str);
+                __m128i const special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)), _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+                u32 const     mask    = (u32)_mm_movemask_epi8(special);
+                if (mask != 0)
+                    return str + JsonCountTrailingZeros64(mask);
+                str += 16;
+            }
+#endif
+            while (str < end)
+            {
+                u8 const c = (u8)*str;
+                if (c == '"' || c == '\\' || c < 0x20)
+                    break;
+                ++str;
+            }
+            return str;
+        }
+
+        s32 JsonCountNumberArray(char const* str, char const* end)
+        {
+            s32  separators = 0;
+            bool empty      = true;
+            for (; str < end; ++str)
+            {
+                char const c = *str;
+                if (c == ']')
+                    return empty ? 0 : separators + 1;
+                if (c == ',')
+                    separators += 1;
+                else if ((g_JsonCharClass[(u8)c] & (kJsonCharNumber | kJsonCharWhitespace)) == 0)
+                    return -1;
+                else if ((g_JsonCharClass[(u8)c] & kJsonCharNumber) != 0)
+                    empty = false;
+            }
+            return -1;
+        }
+
+        s32 JsonCountNewlines(char const* str, char const* end)
+        {
+            s32 count = 0;
+#if defined(CJSON_SIMD_AVX2)
+            __m256i const newline = _mm256_set1_epi8('\n');
+            while ((end - str) >= 32)
+            {
+                u32 const mask = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i const*)str), newline));
+                count += JsonPopCount64(mask);
+                str += 32;
+            }
+#elif defined(CJSON_SIMD_SSE2)
+            __m128i const newline = _mm_set1_epi8('\n');
+            while ((end - str) >= 16)
+            {
+                u32 const mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((__m128i const*)str), newline));
+                count += JsonPopCount64(mask);
+                str += 16;
+            }
+#else
+            // A byte of 'x' is zero when the high bit of ((x & 0x7F) + 0x7F) | x is clear
+            u64 const newlines = 0x0A0A0A0A0A0A0A0Aull;
+            u64 const low7     = 0x7F7F7F7F7F7F7F7Full;
+            while ((end - str) >= 8)
+            {
+                u64 word;
+                nmem::memcpy(&word, str, sizeof(word));
+                word ^= newlines;
+                u64 const t = ((word & low7) + low7) | word;
+                count += JsonPopCount64(~t & ~low7);
+                str += 8;
+            }
+#endif
+            while (str < end)
+            {
+                count += (*str++ == '\n') ? 1 : 0;
+            }
+            return count;
+        }
+
+        void JsonTextPosition(char const* begin, char const* pos, s32& out_line, s32& out_column)
+        {
+            char const* line_begin = pos;
+            while (line_begin > begin && line_begin[-1] != '\n')
+                --line_begin;
+            out_line   = 1 + JsonCountNewlines(begin, line_begin);
+            out_column = 1 + (s32)(pos - line_begin);
+        }
+
+    } // namespace njson
+} // namespace ncore
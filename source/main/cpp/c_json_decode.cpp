@@ -7,7 +7,8 @@
 #include "cjson/c_json_utils.h"
 #include "cjson/c_json_allocator.h"
 #include "cjson/c_json_decode.h"
-#include "cjson/c_json_parser_lexer.h"
+#include "cjson/c_json_lexer.h"
+#include "cjson/c_json_charclass.h"
 
 namespace ncore
 {
@@ -378,23 +379,97 @@ namespace ncore
     {
         using namespace njson;
 
-        struct JsonState
+        // Strings are unescaped into the main allocator, numbers and booleans are converted
+        typedef JsonLexerPolicy<JsonStringCopy, JsonNumberConvert, JsonUtf8Trust> JsonDecodeLexer;
+
+        // The value of a member without a descriptor is skipped, strings are not copied and numbers are not converted
+        typedef JsonLexerPolicy<JsonStringSpan, JsonNumberRaw, JsonUtf8Trust> JsonSkipLexer;
+
+        // The elements of an array are collected in scratch, the array is allocated once the count is known
+        struct ListElem
+        {
+            union
+            {
+                void* m_ElemData;
+                u64   m_ElemData64;
+            };
+            ListElem* m_Next;
+        };
+
+        struct ValueList
         {
-            JsonLexerState m_Lexer;
-            char*          m_ErrorMessage;
-            JsonAllocator* m_Allocator;
             JsonAllocator* m_Scratch;
-            int            m_NumberOfObjects;
-            int            m_NumberOfNumbers;
-            int            m_NumberOfStrings;
-            int            m_NumberOfEnums;
-            int            m_NumberOfArrays;
-            int            m_NumberOfBooleans;
+            ListElem       m_Head;
+            ListElem*      m_Tail;
+            s32            m_Count;
+
+            void Init(JsonAllocator* scratch)
+            {
+                m_Scratch = scratch;
+                m_Tail    = &m_Head;
+                m_Count   = 0;
+            }
+
+            ListElem* NewListItem()
+            {
+                ListElem* elem     = m_Scratch->Allocate<ListElem>();
+                elem->m_Next       = nullptr;
+                elem->m_ElemData64 = 0;
+                return elem;
+            }
+
+            void Add(ListElem* elem)
+            {
+                m_Tail->m_Next = elem;
+                m_Tail         = elem;
+                m_Count += 1;
+            }
+        };
+
+        // An array or object that is being decoded. Frames are chained by depth and reused when the document
+        // goes up and down again. A closed array releases the scratch memory of its elements, including the
+        // frames that were first allocated while decoding it.
+        struct JsonDecodeFrame
+        {
+            JsonDecodeFrame* m_Parent;
+            JsonDecodeFrame* m_Child;
+            JsonDecodeFrame* m_Deepest;     // array, deepest frame allocated before the array was opened
+            JsonObject       m_Object;      // object: the object being decoded, array: the object that owns the array member
+            JsonMember       m_Member;      // array, the array member
+            ValueList        m_Values;      // array, the decoded elements
+            s64              m_ScratchSize; // array, size of scratch when the array was opened
+            bool             m_IsArray;
+            bool             m_SeenValue;
+            bool             m_SeenComma;
+        };
+
+        struct JsonState
+        {
+            JsonLexerState   m_Lexer;
+            JsonDecodeFrame* m_Top;
+            JsonDecodeFrame* m_Frames;  // the frame of depth 1, deeper frames are chained
+            JsonDecodeFrame* m_Deepest; // the last frame in the chain
+            s32              m_Depth;
+            s32              m_MaxDepth;
+            char*            m_ErrorMessage;
+            JsonAllocator*   m_Allocator;
+            JsonAllocator*   m_Scratch;
+            int              m_NumberOfObjects;
+            int              m_NumberOfNumbers;
+            int              m_NumberOfStrings;
+            int              m_NumberOfEnums;
+            int              m_NumberOfArrays;
+            int              m_NumberOfBooleans;
         };
 
-        static void JsonStateInit(JsonState* state, JsonAllocator* alloc, JsonAllocator* scratch, char const* buffer, char const* end)
+        static void JsonStateInit(JsonState* state, JsonAllocator* alloc, JsonAllocator* scratch, char const* buffer, char const* end, s32 max_depth)
         {
             JsonLexerStateInit(&state->m_Lexer, buffer, end, alloc, scratch);
+            state->m_Top              = nullptr;
+            state->m_Frames           = nullptr;
+            state->m_Deepest          = nullptr;
+            state->m_Depth            = 0;
+            state->m_MaxDepth         = max_depth;
             state->m_ErrorMessage     = nullptr;
             state->m_Allocator        = alloc;
             state->m_Scratch          = scratch;
@@ -415,223 +490,218 @@ namespace ncore
         {
             state->m_ErrorMessage = state->m_Scratch->AllocateArray<char>(1024);
             runes_t  errmsg       = ascii::make_runes(state->m_ErrorMessage, state->m_ErrorMessage + 1024 - 1);
-            crunes_t fmt          = ascii::make_crunes("line %d: %s");
-            sprintf(errmsg, fmt, va_t(state->m_Lexer.m_LineNumber), va_t(error));
+            crunes_t fmt          = ascii::make_crunes("line %d, column %d: %s");
+            s32      line, column;
+            JsonLexerPosition(&state->m_Lexer, line, column);
+            sprintf(errmsg, fmt, va_t(line), va_t(column), va_t(error));
             JsonError* jsonError      = state->m_Scratch->Allocate<JsonError>();
             jsonError->m_ErrorMessage = state->m_ErrorMessage;
             return jsonError;
         }
 
+        static JsonError* JsonDecodePush(JsonState* json_state, JsonObject const& object, JsonMember const& member, bool is_array)
+        {
+            if (json_state->m_Depth == json_state->m_MaxDepth)
+                return MakeJsonError(json_state, "maximum nesting depth exceeded");
+
+            JsonDecodeFrame* top   = json_state->m_Top;
+            JsonDecodeFrame* frame = top != nullptr ? top->m_Child : json_state->m_Frames;
+            if (frame == nullptr)
+            {
+                frame           = json_state->m_Scratch->Allocate<JsonDecodeFrame>();
+                frame->m_Parent = top;
+                frame->m_Child  = nullptr;
+                if (top != nullptr)
+                    top->m_Child = frame;
+                else
+                    json_state->m_Frames = frame;
+                json_state->m_Deepest = frame;
+            }
+
+            frame->m_Object    = object;
+            frame->m_Member    = member;
+            frame->m_IsArray   = is_array;
+            frame->m_SeenValue = false;
+            frame->m_SeenComma = false;
+            if (is_array)
+            {
+                frame->m_ScratchSize = json_state->m_Scratch->m_Size;
+                frame->m_Deepest     = json_state->m_Deepest;
+                frame->m_Values.Init(json_state->m_Scratch);
+            }
+
+            json_state->m_Top = frame;
+            json_state->m_Depth += 1;
+            return nullptr;
+        }
+
+        static void JsonDecodePop(JsonState* json_state)
+        {
+            JsonDecodeFrame* frame = json_state->m_Top;
+            if (frame->m_IsArray)
+            {
+                // Release the scratch memory of the array, frames allocated after it was opened are gone as well
+                json_state->m_Scratch->m_Size  = frame->m_ScratchSize;
+                json_state->m_Deepest          = frame->m_Deepest;
+                json_state->m_Deepest->m_Child = nullptr;
+            }
+
+            json_state->m_Top = frame->m_Parent;
+            json_state->m_Depth -= 1;
+        }
+
         static JsonError* JsonDecodeValue(JsonState* json_state, JsonObject& object, JsonMember& member);
 
-        static JsonError* JsonDecodeObject(JsonState* json_state, JsonObject& object)
+        // Skip the value of an unknown member, an array or object is skipped by matching its brackets without allocating
+        // anything, its content is not checked.
+        static JsonError* JsonDecodeSkipValue(JsonState* json_state)
         {
             JsonLexerState* lexer = &json_state->m_Lexer;
+            JsonLexeme      l     = JsonLexerNext<JsonSkipLexer>(lexer);
+            switch (l.m_Type)
+            {
+                case kJsonLexBeginObject:
+                case kJsonLexBeginArray:
+                    if (JsonLexerSkipContainer(lexer) == nullptr)
+                        return MakeJsonError(json_state, "end of file inside array or object");
+                    return nullptr;
 
-            if (!JsonLexerExpect(lexer, kJsonLexBeginObject))
-                return MakeJsonError(json_state, "expected '{'");
+                case kJsonLexString:
+                case kJsonLexNumber:
+                case kJsonLexBoolean:
+                case kJsonLexNull: return nullptr;
 
-            bool seen_value = false;
-            bool seen_comma = false;
+                default: return MakeJsonError(json_state, "invalid document");
+            }
+        }
+
+        // Decode members until the object is closed or the value of a member is an array or object, which is
+        // then pushed as a new frame.
+        static JsonError* JsonDecodeObjectStep(JsonState* json_state, JsonDecodeFrame* frame)
+        {
+            JsonLexerState* lexer = &json_state->m_Lexer;
+            JsonDecodeFrame* top  = json_state->m_Top;
 
-            bool done = false;
-            while (!done)
+            for (;;)
             {
-                JsonLexeme l = JsonLexerNext(lexer);
+                // A name is only needed for the lookup, it is not copied
+                JsonLexeme l = JsonLexerNext<JsonSkipLexer>(lexer);
 
                 switch (l.m_Type)
                 {
-                    case kJsonLexEndObject: done = true; break;
+                    case kJsonLexEndObject: JsonDecodePop(json_state); return nullptr;
 
                     case kJsonLexString:
                     {
-                        if (seen_value && !seen_comma)
+                        if (frame->m_SeenValue && !frame->m_SeenComma)
                             return MakeJsonError(json_state, "expected ','");
 
-                        if (!JsonLexerExpect(lexer, kJsonLexNameSeparator))
+                        if (!JsonLexerExpect<JsonDecodeLexer>(lexer, kJsonLexNameSeparator))
                             return MakeJsonError(json_state, "expected ':'");
 
-                        JsonMember member = object.get_member(l.m_String.m_Str, l.m_String.m_Str + l.m_String.m_Len);
-                        JsonError* err    = JsonDecodeValue(json_state, object, member);
+                        frame->m_SeenValue = true;
+                        frame->m_SeenComma = false;
+
+                        // A name with escape sequences is unescaped into scratch, which is not committed
+                        char const* name     = l.m_String.m_Str;
+                        char const* name_end = name + l.m_String.m_Len;
+                        if (JsonFindStringSpecial(name, name_end) != name_end)
+                        {
+                            name = JsonLexerUnescapeScratch(lexer, l.m_String.m_Str, name_end, name_end);
+                            if (name == nullptr)
+                                return MakeJsonError(json_state, "invalid member name");
+                        }
+
+                        JsonMember member = frame->m_Object.get_member(name, name_end);
+                        if (!member.has_descr())
+                        {
+                            JsonError* err = JsonDecodeSkipValue(json_state);
+                            if (err != nullptr)
+                                return err;
+                            break;
+                        }
+
+                        JsonError* err = JsonDecodeValue(json_state, frame->m_Object, member);
                         if (err != nullptr)
                             return err;
-
-                        seen_value = true;
-                        seen_comma = false;
+                        if (json_state->m_Top != top)
+                            return nullptr;
                     }
                     break;
 
                     case kJsonLexValueSeparator:
                     {
-                        if (!seen_value)
+                        if (!frame->m_SeenValue)
                             return MakeJsonError(json_state, "expected key name");
 
-                        if (seen_comma)
+                        if (frame->m_SeenComma)
                             return MakeJsonError(json_state, "duplicate comma");
 
-                        seen_value = false;
-                        seen_comma = true;
+                        frame->m_SeenValue = false;
+                        frame->m_SeenComma = true;
                         break;
                     }
 
                     default: return MakeJsonError(json_state, "expected object to continue");
                 }
             }
-
-            return nullptr;
         }
 
-        static JsonError* JsonDecodeArray(JsonState* json_state, JsonObject& object, JsonMember& member)
+        // The destination of an array member, a carray in the object or a vector that is allocated here, 'count' is clamped to what fits.
+        // Returns nullptr when the member is neither.
+        static void* JsonDecodeArrayTarget(JsonObject& object, JsonMember& member, JsonAllocator* alloc, s32& count)
         {
-            JsonLexerState* lexer = &json_state->m_Lexer;
-
-            if (!JsonLexerExpect(lexer, kJsonLexBeginArray))
-                return MakeJsonError(json_state, "expected '['");
-
-            JsonAllocatorScope scratch_scope(json_state->m_Scratch);
-
-            struct ListElem
+            void* array = nullptr;
+            if (member.is_array_ptr())
             {
-                union
-                {
-                    void* m_ElemData;
-                    u64   m_ElemData64;
-                };
-                ListElem* m_Next;
-            };
+                JsonObjectTypeDef const* obj_type_def = object.m_descr->as_object_type();
 
-            struct ValueList
-            {
-                JsonAllocator* m_Scratch;
-                ListElem       m_Head;
-                ListElem*      m_Tail;
-                s32            m_Count;
-
-                void Init(JsonAllocator* scratch)
+                if (member.is_array_ptr_size8())
                 {
-                    m_Scratch = scratch;
-                    m_Tail    = &m_Head;
-                    m_Count   = 0;
-                }
+                    if (count > 127)
+                        count = 127;
 
-                ListElem* NewListItem()
-                {
-                    ListElem* elem     = m_Scratch->Allocate<ListElem>();
-                    elem->m_Next       = nullptr;
-                    elem->m_ElemData64 = 0;
-                    return elem;
+                    ptr_t const offset = (ptr_t)member.m_descr->m_size8 - (ptr_t)obj_type_def->m_default;
+                    s8*         size8  = (s8*)((ptr_t)object.m_instance + offset);
+                    *size8             = (s8)count;
                 }
-
-                void Add(ListElem* elem)
+                else if (member.is_array_ptr_size16())
                 {
-                    m_Tail->m_Next = elem;
-                    m_Tail         = elem;
-                    m_Count += 1;
-                }
-            };
-
-            JsonAllocator* scratch = json_state->m_Scratch;
-
-            ValueList value_list;
-            value_list.Init(scratch);
-
-            for (;;)
-            {
-                JsonLexeme l = JsonLexerPeek(lexer);
-
-                if (kJsonLexEndArray == l.m_Type)
-                {
-                    JsonLexerSkip(lexer);
-                    break;
-                }
-
-                if (value_list.m_Count > 0)
-                {
-                    if (kJsonLexValueSeparator != l.m_Type)
-                    {
-                        return MakeJsonError(json_state, "expected ','");
-                    }
-
-                    JsonLexerSkip(lexer);
-                }
-
-                JsonError* err = nullptr;
-                if (member.has_descr())
-                {
-                    ListElem* elem = value_list.NewListItem();
-
-                    JsonMember m = member;
-                    if (m.is_pointer() || m.is_string() || m.is_number() || m.is_bool())
-                    {
-                        m.m_data_ptr = &elem->m_ElemData64;
-                    }
-                    else if (m.is_object())
-                    {
-                        void* obj;
-                        json_alloc_object(m.m_descr->m_typedescr, scratch, 1, obj);
-                        elem->m_ElemData = obj;
-                        m.m_data_ptr     = obj;
-                    }
-                    err = JsonDecodeValue(json_state, object, m);
-                    value_list.Add(elem);
+                    if (count > 32767)
+                        count = 32767;
+                    ptr_t const offset = (ptr_t)member.m_descr->m_size16 - (ptr_t)obj_type_def->m_default;
+                    s16*        size16 = (s16*)((ptr_t)object.m_instance + offset);
+                    *size16            = (s16)count;
                 }
-                else
+                else if (member.is_array_ptr_size32())
                 {
-                    ListElem* elem = value_list.NewListItem();
-                    err            = JsonDecodeValue(json_state, object, member);
-                    value_list.Add(elem);
+                    if (count > 2147483647)
+                        count = 2147483647;
+                    ptr_t const offset = (ptr_t)member.m_descr->m_size32 - (ptr_t)obj_type_def->m_default;
+                    s32*        size32 = (s32*)((ptr_t)object.m_instance + offset);
+                    *size32            = count;
                 }
-
-                if (err != nullptr)
-                    return err;
+                array = alloc->Allocate(count * (member.m_descr->m_typedescr->m_sizeof), member.m_descr->m_typedescr->m_alignof);
+            }
+            else if (member.is_array())
+            {
+                array = member.get_member_ptr(object);
+                count = count > member.m_descr->m_csize ? member.m_descr->m_csize : count;
             }
+            return array;
+        }
 
+        // Move the decoded elements into the array member, a carray or a vector that is allocated here
+        static JsonError* JsonDecodeArrayFinish(JsonState* json_state, JsonObject& object, JsonMember& member, ValueList& value_list)
+        {
             if (member.has_descr())
             {
                 JsonAllocator* alloc = json_state->m_Allocator;
 
                 s32   count = value_list.m_Count;
-                void* array = nullptr;
-                if (member.is_array_ptr())
-                {
-                    JsonObjectTypeDef const* obj_type_def = object.m_descr->as_object_type();
-
-                    if (member.is_array_ptr_size8())
-                    {
-                        if (count > 127)
-                            count = 127;
-
-                        ptr_t const offset = (ptr_t)member.m_descr->m_size8 - (ptr_t)obj_type_def->m_default;
-                        s8*         size8  = (s8*)((ptr_t)object.m_instance + offset);
-                        *size8             = (s8)count;
-                    }
-                    else if (member.is_array_ptr_size16())
-                    {
-                        if (count > 32767)
-                            count = 32767;
-                        ptr_t const offset = (ptr_t)member.m_descr->m_size16 - (ptr_t)obj_type_def->m_default;
-                        s16*        size16 = (s16*)((ptr_t)object.m_instance + offset);
-                        *size16            = (s16)count;
-                    }
-                    else if (member.is_array_ptr_size32())
-                    {
-                        if (count > 2147483647)
-                            count = 2147483647;
-                        ptr_t const offset = (ptr_t)member.m_descr->m_size32 - (ptr_t)obj_type_def->m_default;
-                        s32*        size32 = (s32*)((ptr_t)object.m_instance + offset);
-                        *size32            = count;
-                    }
-                    array = alloc->Allocate(count * (member.m_descr->m_typedescr->m_sizeof), member.m_descr->m_typedescr->m_alignof);
-                }
-                else if (member.is_array())
-                {
-                    array = member.get_member_ptr(object);
-                    count = count > member.m_descr->m_csize ? member.m_descr->m_csize : count;
-                }
-                else
-                {
+                void* array = JsonDecodeArrayTarget(object, member, alloc, count);
+                if (array == nullptr)
                     return MakeJsonError(json_state, "expected either a carray or vector");
-                }
 
                 ListElem* elem = value_list.m_Head.m_Next;
 
@@ -737,10 +807,118 @@ namespace ncore
             return nullptr;
         }
 
+        // An array of numbers for a numeric array member, the element count is known from a byte scan so the destination is allocated once
+        // and every number is stored straight into it, no list elements are allocated. The '[' has been consumed.
+        static JsonError* JsonDecodeNumberArray(JsonState* json_state, JsonObject& object, JsonMember& member, s32 count)
+        {
+            JsonLexerState* lexer    = &json_state->m_Lexer;
+            s32             capacity = count;
+            void*           array    = JsonDecodeArrayTarget(object, member, json_state->m_Allocator, capacity);
+            if (array == nullptr)
+                return MakeJsonError(json_state, "expected either a carray or vector");
+
+            JsonMember element   = member;
+            s32 const  elem_size = member.m_descr->m_typedescr->m_sizeof;
+            for (s32 i = 0; i < count; ++i)
+            {
+                if (i > 0 && !JsonLexerExpect<JsonDecodeLexer>(lexer, kJsonLexValueSeparator))
+                    return MakeJsonError(json_state, "expected ','");
+
+                JsonLexeme l = JsonLexerNext<JsonDecodeLexer>(lexer);
+                if (l.m_Type != kJsonLexNumber)
+                    return MakeJsonError(json_state, "invalid document");
+
+                json_state->m_NumberOfNumbers += 1;
+                if (i < capacity)
+                {
+                    element.m_data_ptr = (char*)array + (i * elem_size);
+                    element.set_number(object, json_state->m_Allocator, l.m_Number);
+                }
+            }
+
+            if (!JsonLexerExpect<JsonDecodeLexer>(lexer, kJsonLexEndArray))
+                return MakeJsonError(json_state, "expected ']'");
+
+            if (member.is_array_ptr())
+            {
+                void** ptr = (void**)member.get_member_ptr(object);
+                *ptr       = array;
+            }
+            return nullptr;
+        }
+
+        // Decode elements until the array is closed or an element is an array or object, which is then pushed
+        // as a new frame.
+        static JsonError* JsonDecodeArrayStep(JsonState* json_state, JsonDecodeFrame* frame)
+        {
+            JsonLexerState*  lexer      = &json_state->m_Lexer;
+            JsonDecodeFrame* top        = json_state->m_Top;
+            JsonAllocator*   scratch    = json_state->m_Scratch;
+            JsonObject&      object     = frame->m_Object;
+            JsonMember&      member     = frame->m_Member;
+            ValueList&       value_list = frame->m_Values;
+
+            for (;;)
+            {
+                JsonLexeme l = JsonLexerPeek<JsonDecodeLexer>(lexer);
+
+                if (kJsonLexEndArray == l.m_Type)
+                {
+                    JsonLexerSkip<JsonDecodeLexer>(lexer);
+                    JsonError* err = JsonDecodeArrayFinish(json_state, object, member, value_list);
+                    if (err != nullptr)
+                        return err;
+                    JsonDecodePop(json_state);
+                    return nullptr;
+                }
+
+                if (value_list.m_Count > 0)
+                {
+                    if (kJsonLexValueSeparator != l.m_Type)
+                    {
+                        return MakeJsonError(json_state, "expected ','");
+                    }
+
+                    JsonLexerSkip<JsonDecodeLexer>(lexer);
+                }
+
+                JsonError* err = nullptr;
+                if (member.has_descr())
+                {
+                    ListElem* elem = value_list.NewListItem();
+                    value_list.Add(elem);
+
+                    JsonMember m = member;
+                    if (m.is_pointer() || m.is_string() || m.is_number() || m.is_bool())
+                    {
+                        m.m_data_ptr = &elem->m_ElemData64;
+                    }
+                    else if (m.is_object())
+                    {
+                        void* obj;
+                        json_alloc_object(m.m_descr->m_typedescr, scratch, 1, obj);
+                        elem->m_ElemData = obj;
+                        m.m_data_ptr     = obj;
+                    }
+                    err = JsonDecodeValue(json_state, object, m);
+                }
+                else
+                {
+                    value_list.Add(value_list.NewListItem());
+                    err = JsonDecodeValue(json_state, object, member);
+                }
+
+                if (err != nullptr)
+                    return err;
+                if (json_state->m_Top != top)
+                    return nullptr;
+            }
+        }
+
         JsonError* JsonDecodeValue(JsonState* json_state, JsonObject& object, JsonMember& member)
         {
             JsonError* err = nullptr;
-            JsonLexeme l   = JsonLexerPeek(&json_state->m_Lexer);
+            JsonLexeme l   = JsonLexerPeek<JsonDecodeLexer>(&json_state->m_Lexer);
             switch (l.m_Type)
             {
                 case kJsonLexBeginObject:
@@ -753,7 +931,8 @@ namespace ncore
                         member_object = member.get_object(object, json_state->m_Allocator);
                     }
                     json_state->m_NumberOfObjects += 1;
-                    err = JsonDecodeObject(json_state, member_object);
+                    err = JsonDecodePush(json_state, member_object, JsonMember(), false);
+                    JsonLexerSkip<JsonDecodeLexer>(&json_state->m_Lexer);
                 }
                 break;
                 case kJsonLexBeginArray:
@@ -761,7 +940,17 @@ namespace ncore
                         return MakeJsonError(json_state, "encountered json array but class member is not the same type");
 
                     json_state->m_NumberOfArrays += 1;
-                    err = JsonDecodeArray(json_state, object, member);
+                    JsonLexerSkip<JsonDecodeLexer>(&json_state->m_Lexer);
+                    if (member.has_descr() && member.is_number() && !member.is_bool() && !member.is_pointer())
+                    {
+                        s32 const count = JsonCountNumberArray(json_state->m_Lexer.m_Cursor, json_state->m_Lexer.m_End);
+                        if (count >= 0)
+                        {
+                            err = JsonDecodeNumberArray(json_state, object, member, count);
+                            break;
+                        }
+                    }
+                    err = JsonDecodePush(json_state, object, member, true);
                     break;
 
                 case kJsonLexString:
@@ -810,7 +999,7 @@ namespace ncore
                     {
                         json_state->m_NumberOfNumbers += 1;
                     }
-                    JsonLexerSkip(&json_state->m_Lexer);
+                    JsonLexerSkip<JsonDecodeLexer>(&json_state->m_Lexer);
                     break;
                 }
                 case kJsonLexNumber:
@@ -824,7 +1013,7 @@ namespace ncore
                         member.set_number(object, json_state->m_Allocator, l.m_Number);
                     }
 
-                    JsonLexerSkip(&json_state->m_Lexer);
+                    JsonLexerSkip<JsonDecodeLexer>(&json_state->m_Lexer);
                     break;
                 }
 
@@ -838,10 +1027,10 @@ namespace ncore
                         member.set_bool(object, json_state->m_Allocator, l.m_Number.m_S64 != 0);
                     }
 
-                    JsonLexerSkip(&json_state->m_Lexer);
+                    JsonLexerSkip<JsonDecodeLexer>(&json_state->m_Lexer);
                     break;
 
-                case kJsonLexNull: JsonLexerSkip(&json_state->m_Lexer); break;
+                case kJsonLexNull: JsonLexerSkip<JsonDecodeLexer>(&json_state->m_Lexer); break;
 
                 default: return MakeJsonError(json_state, "invalid document");
             }
@@ -849,17 +1038,33 @@ namespace ncore
             return err;
         }
 
-        bool JsonDecode(char const* str, char const* end, JsonObject& json_root, JsonAllocator* allocator, JsonAllocator* scratch, char const*& error_message)
+        static JsonError* JsonDecodeDocument(JsonState* json_state, JsonObject& json_root)
+        {
+            JsonLexerState* lexer = &json_state->m_Lexer;
+
+            if (!JsonLexerExpect<JsonDecodeLexer>(lexer, kJsonLexBeginObject))
+                return MakeJsonError(json_state, "expected '{'");
+
+            JsonError* err = JsonDecodePush(json_state, json_root, JsonMember(), false);
+            while (err == nullptr && json_state->m_Top != nullptr)
+            {
+                JsonDecodeFrame* frame = json_state->m_Top;
+                err                    = frame->m_IsArray ? JsonDecodeArrayStep(json_state, frame) : JsonDecodeObjectStep(json_state, frame);
+            }
+            return err;
+        }
+
+        bool JsonDecode(char const* str, char const* end, JsonObject& json_root, JsonAllocator* allocator, JsonAllocator* scratch, s32 max_depth, char const*& error_message)
         {
             JsonAllocatorScope scratch_scope(scratch);
 
             JsonState* json_state = scratch->Allocate<JsonState>();
-            JsonStateInit(json_state, allocator, scratch, str, end);
+            JsonStateInit(json_state, allocator, scratch, str, end, max_depth);
 
-            JsonError* error = JsonDecodeObject(json_state, json_root);
+            JsonError* error = JsonDecodeDocument(json_state, json_root);
             if (error == nullptr)
             {
-                if (!JsonLexerExpect(&json_state->m_Lexer, kJsonLexEof))
+                if (!JsonLexerExpect<JsonDecodeLexer>(&json_state->m_Lexer, kJsonLexEof))
                 {
                     error = MakeJsonError(json_state, "data after document");
                 }
@@ -882,6 +1087,7 @@ namespace ncore
 
     namespace njson
     {
-        bool JsonDecode(char const* str, char const* end, JsonObject& json_root, JsonAllocator* allocator, JsonAllocator* scratch, char const*& error_message) { return json_decoder::JsonDecode(str, end, json_root, allocator, scratch, error_message); }
+        bool JsonDecode(char const* str, char const* end, JsonObject& json_root, JsonAllocator* allocator, JsonAllocator* scratch, char const*& error_message) { return json_decoder::JsonDecode(str, end, json_root, allocator, scratch, kJsonDefaultMaxDepth, error_message); }
+        bool JsonDecode(char const* str, char const* end, JsonObject& json_root, JsonAllocator* allocator, JsonAllocator* scratch, s32 max_depth, char const*& error_message) { return json_decoder::JsonDecode(str, end, json_root, allocator, scratch, max_depth, error_message); }
     } // namespace njson
 } // namespace ncore
@@ -237,60 +237,79 @@ namespace ncore
                 }
             }
 
-            template <typename T> void decode_array_integer(decoder_t* d, T*& out_array, i32& out_array_size, i32 out_array_maxsize)
+            // Numeric arrays are converted straight from the scanned elements into the destination, the decoder state is
+            // not pushed and popped for every element. An element that is not a number is stored as 0.
+            static inline void decode_number_value(nscanner::JsonValue const* value, JsonNumber& out_number)
             {
-                result_t result = read_array_begin(d, out_array_size);
-                if (NotOk(result))
+                if (value->IsNumber())
                 {
-                    out_array      = nullptr;
-                    out_array_size = 0;
-                    return;
+                    const char* str = value->m_Value.m_Number.m_String;
+                    ParseNumber(str, value->m_Value.m_Number.m_End, out_number);
                 }
-                if (out_array_maxsize > 0)
+                else if (value->IsBoolean())
                 {
-                    out_array_size = (out_array_size > (i32)out_array_maxsize) ? (i32)out_array_maxsize : out_array_size;
+                    out_number = JsonNumber(kJsonNumber_bool, ParseBoolean(value->m_Value.m_Number.m_String, value->m_Value.m_Number.m_End) ? 1 : 0);
                 }
-                out_array = d->m_DecoderAllocator->AllocateArray<T>(out_array_size);
+            }
 
-                i32 array_index = 0;
-                while (OkAndNotEnded(result))
+            template <typename T> static inline T number_as(JsonNumber const& number) { return (T)JsonNumberAsUInt64(number); }
+            template <> inline bool number_as<bool>(JsonNumber const& number) { return JsonNumberAsUInt64(number) != 0; }
+            template <> inline i8 number_as<i8>(JsonNumber const& number) { return (i8)JsonNumberAsInt64(number); }
+            template <> inline i16 number_as<i16>(JsonNumber const& number) { return (i16)JsonNumberAsInt64(number); }
+            template <> inline i32 number_as<i32>(JsonNumber const& number) { return (i32)JsonNumberAsInt64(number); }
+            template <> inline i64 number_as<i64>(JsonNumber const& number) { return (i64)JsonNumberAsInt64(number); }
+            template <> inline f32 number_as<f32>(JsonNumber const& number) { return (f32)JsonNumberAsFloat64(number); }
+
+            // The array at the current state, nullptr if the current value is not an array
+            static inline nscanner::JsonArrayValue const* current_array(decoder_t* d)
+            {
+                if (d->m_CurrentState == nullptr || d->m_CurrentState->m_Value == nullptr)
+                    return nullptr;
+                return d->m_CurrentState->m_Value->AsArray();
+            }
+
+            template <typename T> static i32 decode_numbers(nscanner::JsonArrayValue const* array, T* out_array, i32 out_array_maxlen)
+            {
+                i32                              index = 0;
+                nscanner::JsonLinkedValue const* elem  = array->m_LinkedList;
+                for (; elem != nullptr && index < out_array_maxlen; elem = elem->m_Next)
                 {
-                    u64 value = decode_u64(d);
-                    if (array_index < (i32)out_array_size)
-                        out_array[array_index] = (T)value;
-                    array_index++;
-                    result = read_array_end(d);
+                    JsonNumber number;
+                    decode_number_value(elem->m_Value, number);
+                    out_array[index++] = number_as<T>(number);
                 }
+                return index;
             }
 
-            void decode_array_bool(decoder_t* d, bool*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_integer<bool>(d, out_array, out_array_size, out_array_maxsize); }
-            void decode_array_u8(decoder_t* d, u8*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_integer<u8>(d, out_array, out_array_size, out_array_maxsize); }
-            void decode_array_u16(decoder_t* d, u16*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_integer<u16>(d, out_array, out_array_size, out_array_maxsize); }
-            void decode_array_u32(decoder_t* d, u32*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_integer<u32>(d, out_array, out_array_size, out_array_maxsize); }
-            void decode_array_u64(decoder_t* d, u64*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_integer<u64>(d, out_array, out_array_size, out_array_maxsize); }
-            void decode_array_i8(decoder_t* d, i8*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_integer<i8>(d, out_array, out_array_size, out_array_maxsize); }
-            void decode_array_i16(decoder_t* d, i16*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_integer<i16>(d, out_array, out_array_size, out_array_maxsize); }
-            void decode_array_i32(decoder_t* d, i32*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_integer<i32>(d, out_array, out_array_size, out_array_maxsize); }
-            void decode_array_i64(decoder_t* d, i64*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_integer<i64>(d, out_array, out_array_size, out_array_maxsize); }
-            void decode_array_f32(decoder_t* d, f32*& out_array, i32& out_array_size, i32 out_array_maxsize)
+            template <typename T> void decode_array_number(decoder_t* d, T*& out_array, i32& out_array_size, i32 out_array_maxsize)
             {
-                i32      array_size;
-                result_t result = read_array_begin(d, array_size);
-                array_size      = (array_size > (i32)out_array_maxsize) ? (i32)out_array_maxsize : array_size;
-                out_array_size  = (u32)array_size;
-                out_array       = d->m_DecoderAllocator->AllocateArray<f32>(out_array_size);
-                i32 array_index = 0;
-                while (OkAndNotEnded(result))
+                nscanner::JsonArrayValue const* array = current_array(d);
+                if (array == nullptr || array->m_Count == 0)
                 {
-                    float color_component =                     decode_f32(d);
-                    if (array_index < (i32)out_array_size)
-                        out_array[array_index] = color_component;
-                    array_index++;
-                    result = read_array_end(d);
+                    out_array      = nullptr;
+                    out_array_size = 0;
+                    return;
                 }
+
+                i32 count = array->m_Count;
+                if (out_array_maxsize > 0 && count > out_array_maxsize)
+                    count = out_array_maxsize;
+                out_array      = d->m_DecoderAllocator->AllocateArray<T>(count);
+                out_array_size = decode_numbers<T>(array, out_array, count);
             }
 
-            void decode_array_char(decoder_t* d, char*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_integer<char>(d, out_array, out_array_size, out_array_maxsize); }
+            void decode_array_bool(decoder_t* d, bool*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_number<bool>(d, out_array, out_array_size, out_array_maxsize); }
+            void decode_array_u8(decoder_t* d, u8*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_number<u8>(d, out_array, out_array_size, out_array_maxsize); }
+            void decode_array_u16(decoder_t* d, u16*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_number<u16>(d, out_array, out_array_size, out_array_maxsize); }
+            void decode_array_u32(decoder_t* d, u32*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_number<u32>(d, out_array, out_array_size, out_array_maxsize); }
+            void decode_array_u64(decoder_t* d, u64*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_number<u64>(d, out_array, out_array_size, out_array_maxsize); }
+            void decode_array_i8(decoder_t* d, i8*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_number<i8>(d, out_array, out_array_size, out_array_maxsize); }
+            void decode_array_i16(decoder_t* d, i16*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_number<i16>(d, out_array, out_array_size, out_array_maxsize); }
+            void decode_array_i32(decoder_t* d, i32*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_number<i32>(d, out_array, out_array_size, out_array_maxsize); }
+            void decode_array_i64(decoder_t* d, i64*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_number<i64>(d, out_array, out_array_size, out_array_maxsize); }
+            void decode_array_f32(decoder_t* d, f32*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_number<f32>(d, out_array, out_array_size, out_array_maxsize); }
+
+            void decode_array_char(decoder_t* d, char*& out_array, i32& out_array_size, i32 out_array_maxsize) { decode_array_number<char>(d, out_array, out_array_size, out_array_maxsize); }
 
             void decode_array_str(decoder_t* d, const char**& out_array, i32& out_array_size, i32 out_array_maxsize)
             {
@@ -317,33 +336,23 @@ namespace ncore
                 }
             }
 
-            template <typename T> void decode_carray_integer(decoder_t* d, T* out_array, i32 out_array_maxlen)
+            template <typename T> void decode_carray_number(decoder_t* d, T* out_array, i32 out_array_maxlen)
             {
-                i32      array_size;
-                result_t result = read_array_begin(d, array_size);
-                if (NotOk(result))
-                    return;
-                i32 array_index = 0;
-                while (OkAndNotEnded(result))
-                {
-                    u64 value = decode_u64(d);
-                    if (array_index < (i32)out_array_maxlen)
-                        out_array[array_index] = (T)value;
-                    array_index++;
-                    result = read_array_end(d);
-                }
+                nscanner::JsonArrayValue const* array = current_array(d);
+                if (array != nullptr)
+                    decode_numbers<T>(array, out_array, out_array_maxlen);
             }
 
-            void decode_carray_bool(decoder_t* d, bool* out_array, i32 out_array_maxlen) { decode_carray_integer<bool>(d, out_array, out_array_maxlen); }
-            void decode_carray_u8(decoder_t* d, u8* out_array, i32 out_array_maxlen) { decode_carray_integer<u8>(d, out_array, out_array_maxlen); }
-            void decode_carray_u16(decoder_t* d, u16* out_array, i32 out_array_maxlen) { decode_carray_integer<u16>(d, out_array, out_array_maxlen); }
-            void decode_carray_u32(decoder_t* d, u32* out_array, i32 out_array_maxlen) { decode_carray_integer<u32>(d, out_array, out_array_maxlen); }
-            void decode_carray_u64(decoder_t* d, u64* out_array, i32 out_array_maxlen) { decode_carray_integer<u64>(d, out_array, out_array_maxlen); }
-            void decode_carray_i8(decoder_t* d, i8* out_array, i32 out_array_maxlen) { decode_carray_integer<i8>(d, out_array, out_array_maxlen); }
-            void decode_carray_i16(decoder_t* d, i16* out_array, i32 out_array_maxlen) { decode_carray_integer<i16>(d, out_array, out_array_maxlen); }
-            void decode_carray_i32(decoder_t* d, i32* out_array, i32 out_array_maxlen) { decode_carray_integer<i32>(d, out_array, out_array_maxlen); }
-            void decode_carray_i64(decoder_t* d, i64* out_array, i32 out_array_maxlen) { decode_carray_integer<i64>(d, out_array, out_array_maxlen); }
-            void decode_carray_char(decoder_t* d, char* out_array, i32 out_array_maxlen) { decode_carray_integer<char>(d, out_array, out_array_maxlen); }
+            void decode_carray_bool(decoder_t* d, bool* out_array, i32 out_array_maxlen) { decode_carray_number<bool>(d, out_array, out_array_maxlen); }
+            void decode_carray_u8(decoder_t* d, u8* out_array, i32 out_array_maxlen) { decode_carray_number<u8>(d, out_array, out_array_maxlen); }
+            void decode_carray_u16(decoder_t* d, u16* out_array, i32 out_array_maxlen) { decode_carray_number<u16>(d, out_array, out_array_maxlen); }
+            void decode_carray_u32(decoder_t* d, u32* out_array, i32 out_array_maxlen) { decode_carray_number<u32>(d, out_array, out_array_maxlen); }
+            void decode_carray_u64(decoder_t* d, u64* out_array, i32 out_array_maxlen) { decode_carray_number<u64>(d, out_array, out_array_maxlen); }
+            void decode_carray_i8(decoder_t* d, i8* out_array, i32 out_array_maxlen) { decode_carray_number<i8>(d, out_array, out_array_maxlen); }
+            void decode_carray_i16(decoder_t* d, i16* out_array, i32 out_array_maxlen) { decode_carray_number<i16>(d, out_array, out_array_maxlen); }
+            void decode_carray_i32(decoder_t* d, i32* out_array, i32 out_array_maxlen) { decode_carray_number<i32>(d, out_array, out_array_maxlen); }
+            void decode_carray_i64(decoder_t* d, i64* out_array, i32 out_array_maxlen) { decode_carray_number<i64>(d, out_array, out_array_maxlen); }
+            void decode_carray_char(decoder_t* d, char* out_array, i32 out_array_maxlen) { decode_carray_number<char>(d, out_array, out_array_maxlen); }
             void decode_carray_str(decoder_t* d, const char** out_array, i32 out_array_maxlen)
             {
                 i32      array_size;
@@ -360,20 +369,7 @@ namespace ncore
                 }
             }
 
-            void decode_carray_f32(decoder_t* d, f32* out_array, i32 out_array_maxlen)
-            {
-                i32      array_size;
-                result_t result      = read_array_begin(d, array_size);
-                i32      array_index = 0;
-                while (OkAndNotEnded(result))
-                {
-                    float color_component = decode_f32(d);
-                    if (array_index < (i32)out_array_maxlen)
-                        out_array[array_index] = color_component;
-                    array_index++;
-                    result = read_array_end(d);
-                }
-            }
+            void decode_carray_f32(decoder_t* d, f32* out_array, i32 out_array_maxlen) { decode_carray_number<f32>(d, out_array, out_array_maxlen); }
 
             i32 decode_find_enum(decoder_t* d, const char** enum_strs, i32 enum_count)
             {
@@ -723,18 +719,18 @@ namespace ncore
             }
 
             // clang-format off
-            carray_type_t::carray_type_t(bool* out_value, i32 out_value_len) : m_bool(out_value), m_type(TYPE_BOOL), m_value_type(VTYPE_NUMBER) {}
-            carray_type_t::carray_type_t(u8* out_value, i32 out_value_len)  : m_u8(out_value), m_type(TYPE_U8), m_value_type(VTYPE_NUMBER) {}
-            carray_type_t::carray_type_t(u16* out_value, i32 out_value_len)  : m_u16(out_value), m_type(TYPE_U16), m_value_type(VTYPE_NUMBER) {}
-            carray_type_t::carray_type_t(u32* out_value, i32 out_value_len)  : m_u32(out_value), m_type(TYPE_U32), m_value_type(VTYPE_NUMBER) {}
-            carray_type_t::carray_type_t(u64* out_value, i32 out_value_len)  : m_u64(out_value), m_type(TYPE_U64), m_value_type(VTYPE_NUMBER) {}
-            carray_type_t::carray_type_t(i8* out_value, i32 out_value_len)  : m_i8(out_value), m_type(TYPE_I8), m_value_type(VTYPE_NUMBER) {}
-            carray_type_t::carray_type_t(i16* out_value, i32 out_value_len)  : m_i16(out_value), m_type(TYPE_I16), m_value_type(VTYPE_NUMBER) {}
-            carray_type_t::carray_type_t(i32* out_value, i32 out_value_len)  : m_i32(out_value), m_type(TYPE_I32), m_value_type(VTYPE_NUMBER) {}
-            carray_type_t::carray_type_t(i64* out_value, i32 out_value_len)  : m_i64(out_value), m_type(TYPE_I64), m_value_type(VTYPE_NUMBER) {}
-            carray_type_t::carray_type_t(f32* out_value, i32 out_value_len)  : m_f32(out_value), m_type(TYPE_F32), m_value_type(VTYPE_NUMBER) {}
-            carray_type_t::carray_type_t(char* out_value, i32 out_value_len)  : m_char(out_value), m_type(TYPE_CHAR), m_value_type(VTYPE_STRING) {}
-            carray_type_t::carray_type_t(const char** out_value, i32 out_value_len)  : m_str(out_value), m_type(TYPE_STRING), m_value_type(VTYPE_STRING) {}
+            carray_type_t::carray_type_t(bool* out_value, i32 out_value_len) : m_bool(out_value), m_type(TYPE_BOOL), m_value_type(VTYPE_NUMBER), m_maxlen(out_value_len) {}
+            carray_type_t::carray_type_t(u8* out_value, i32 out_value_len)  : m_u8(out_value), m_type(TYPE_U8), m_value_type(VTYPE_NUMBER), m_maxlen(out_value_len) {}
+            carray_type_t::carray_type_t(u16* out_value, i32 out_value_len)  : m_u16(out_value), m_type(TYPE_U16), m_value_type(VTYPE_NUMBER), m_maxlen(out_value_len) {}
+            carray_type_t::carray_type_t(u32* out_value, i32 out_value_len)  : m_u32(out_value), m_type(TYPE_U32), m_value_type(VTYPE_NUMBER), m_maxlen(out_value_len) {}
+            carray_type_t::carray_type_t(u64* out_value, i32 out_value_len)  : m_u64(out_value), m_type(TYPE_U64), m_value_type(VTYPE_NUMBER), m_maxlen(out_value_len) {}
+            carray_type_t::carray_type_t(i8* out_value, i32 out_value_len)  : m_i8(out_value), m_type(TYPE_I8), m_value_type(VTYPE_NUMBER), m_maxlen(out_value_len) {}
+            carray_type_t::carray_type_t(i16* out_value, i32 out_value_len)  : m_i16(out_value), m_type(TYPE_I16), m_value_type(VTYPE_NUMBER), m_maxlen(out_value_len) {}
+            carray_type_t::carray_type_t(i32* out_value, i32 out_value_len)  : m_i32(out_value), m_type(TYPE_I32), m_value_type(VTYPE_NUMBER), m_maxlen(out_value_len) {}
+            carray_type_t::carray_type_t(i64* out_value, i32 out_value_len)  : m_i64(out_value), m_type(TYPE_I64), m_value_type(VTYPE_NUMBER), m_maxlen(out_value_len) {}
+            carray_type_t::carray_type_t(f32* out_value, i32 out_value_len)  : m_f32(out_value), m_type(TYPE_F32), m_value_type(VTYPE_NUMBER), m_maxlen(out_value_len) {}
+            carray_type_t::carray_type_t(char* out_value, i32 out_value_len)  : m_char(out_value), m_type(TYPE_CHAR), m_value_type(VTYPE_STRING), m_maxlen(out_value_len) {}
+            carray_type_t::carray_type_t(const char** out_value, i32 out_value_len)  : m_str(out_value), m_type(TYPE_STRING), m_value_type(VTYPE_STRING), m_maxlen(out_value_len) {}
             // clang-format on
 
             void register_member(decoder_t* d, const char* name, carray_type_t type) { set_basic_member(d, name, type.m_maxlen, type.m_type, type.m_void, type.m_value_type); }
@@ -5,6 +5,7 @@
 #include "cbase/c_runes.h"
 #include "cjson/c_json_parser.h"
 #include "cjson/c_json_utils.h"
+#include "cjson/c_json_float.h"
 #include "cjson/c_json_encode.h"
 #include "cjson/c_json_decode.h"
 
@@ -27,10 +28,10 @@ namespace ncore
 
             switch (member.all_int())
             {
-                case JsonType::TypeUInt8: return (s64)(*(s8*)p);
-                case JsonType::TypeUInt16: return (s64)(*(s16*)p);
-                case JsonType::TypeUInt32: return (s64)(*(s32*)p);
-                case JsonType::TypeUInt64: return (s64)(*(s64*)p);
+                case JsonType::TypeInt8: return (s64)(*(s8*)p);
+                case JsonType::TypeInt16: return (s64)(*(s16*)p);
+                case JsonType::TypeInt32: return (s64)(*(s32*)p);
+                case JsonType::TypeInt64: return (s64)(*(s64*)p);
                 default: break;
             }
             return 0;
@@ -111,6 +112,14 @@ namespace ncore
                 }
             }
 
+            inline void writeEscaped(char const* str)
+            {
+                char const* str_end = str;
+                while (*str_end != 0)
+                    ++str_end;
+                m_json_text = JsonEscapeString(str, str_end, m_json_text, m_json_text_end);
+            }
+
             void writeIndent()
             {
                 s32 n = m_indent >> 6;
@@ -153,7 +162,7 @@ namespace ncore
             void writeValueString(const char* str)
             {
                 writeString("\"");
-                writeString(str);
+                writeEscaped(str);
                 writeString("\"");
             }
 
@@ -182,16 +191,37 @@ namespace ncore
             }
 
             void writeValueBool(bool value) { writeString(value ? "true" : "false"); }
-            void writeValueInt64(s64 field_value) { m_json_text = ascii::itoa(field_value, m_json_text, m_json_text_end, 10); }
-            void writeValueUInt64(u64 field_value) { m_json_text = ascii::utoa(field_value, m_json_text, m_json_text_end, 10); }
-            void writeValueFloat(f32 field_value) { m_json_text = ascii::ftoa(field_value, m_json_text, m_json_text_end); }
-            void writeValueDouble(f64 field_value) { m_json_text = ascii::dtoa(field_value, m_json_text, m_json_text_end); }
+            void writeValueInt64(s64 field_value) { m_json_text = JsonFormatInt64(field_value, m_json_text, m_json_text_end); }
+            void writeValueUInt64(u64 field_value) { m_json_text = JsonFormatUInt64(field_value, m_json_text, m_json_text_end); }
+            void writeValueFloat(f32 field_value) { m_json_text = JsonFormatFloat32(field_value, m_json_text, m_json_text_end); }
+            void writeValueDouble(f64 field_value) { m_json_text = JsonFormatFloat64(field_value, m_json_text, m_json_text_end); }
+
+            // The elements of an integer array in one call, same layout as writing them one by one
+            template <typename T> void writeArraySigned(T const* values, s32 count)
+            {
+                for (s32 i = 0; i < count; ++i)
+                {
+                    writeIndent();
+                    m_json_text = JsonFormatInt64((s64)values[i], m_json_text, m_json_text_end);
+                    end(i == (count - 1));
+                }
+            }
+
+            template <typename T> void writeArrayUnsigned(T const* values, s32 count)
+            {
+                for (s32 i = 0; i < count; ++i)
+                {
+                    writeIndent();
+                    m_json_text = JsonFormatUInt64((u64)values[i], m_json_text, m_json_text_end);
+                    end(i == (count - 1));
+                }
+            }
 
             void startField(const char* field_name)
             {
                 writeIndent();
                 writeString("\"");
-                writeString(field_name);
+                writeEscaped(field_name);
                 writeString("\": ");
             }
 
@@ -245,7 +275,22 @@ namespace ncore
             }
 
             doc.startArray();
-            if (array_size > 0 && array_ptr != nullptr)
+            if (array_size > 0 && array_ptr != nullptr && member.is_integer() && !member.is_pointer())
+            {
+                switch (member.all_int())
+                {
+                    case JsonType::TypeInt8: doc.writeArraySigned((s8 const*)array_ptr, array_size); break;
+                    case JsonType::TypeInt16: doc.writeArraySigned((s16 const*)array_ptr, array_size); break;
+                    case JsonType::TypeInt32: doc.writeArraySigned((s32 const*)array_ptr, array_size); break;
+                    case JsonType::TypeInt64: doc.writeArraySigned((s64 const*)array_ptr, array_size); break;
+                    case JsonType::TypeUInt8: doc.writeArrayUnsigned((u8 const*)array_ptr, array_size); break;
+                    case JsonType::TypeUInt16: doc.writeArrayUnsigned((u16 const*)array_ptr, array_size); break;
+                    case JsonType::TypeUInt32: doc.writeArrayUnsigned((u32 const*)array_ptr, array_size); break;
+                    case JsonType::TypeUInt64: doc.writeArrayUnsigned((u64 const*)array_ptr, array_size); break;
+                    default: break;
+                }
+            }
+            else if (array_size > 0 && array_ptr != nullptr)
             {
                 u32 const aligned_size = member.m_descr->m_typedescr->m_sizeof;
                 for (s32 i = 0; i < array_size; ++i)
@@ -317,11 +362,11 @@ namespace ncore
                 {
                     doc.writeValueDouble(member_as_f64(member));
                 }
-                else if (member.is_int())
+                else if (member.is_signed())
                 {
                     doc.writeValueInt64(member_as_int(member));
                 }
-                else if (member.is_uint())
+                else
                 {
                     doc.writeValueUInt64(member_as_uint(member));
                 }
@@ -0,0 +1,400 @@
+#include "cbase/c_allocator.h"
+#include "cbase/c_context.h"
+#include "cbase/c_memory.h"
+#include "cbase/c_printf.h"
+#include "cbase/c_runes.h"
+#include "cjson/c_json_utils.h"
+#include "cjson/c_json_utf8.h"
+#include "cjson/c_json_charclass.h"
+#include "cjson/c_json_allocator.h"
+#include "cjson/c_json_lexer.h"
+
+namespace ncore
+{
+    namespace njson
+    {
+        // clang-format off
+        const u8 g_JsonTokenClass[256] = {
+            10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8, 2, 0, 0,
+            2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 9, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6, 0, 7, 0, 0,
+            0, 0, 0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 3, 0,
+            0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 4, 0, 5, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        };
+        // clang-format on
+
+        void JsonLexerStateInit(JsonLexerState* self, char const* buffer, char const* end, JsonAllocator* alloc, JsonAllocator* scratch)
+        {
+            self->m_Begin         = buffer;
+            self->m_Cursor        = buffer;
+            self->m_End           = end;
+            self->m_Text          = buffer;
+            self->m_Alloc         = alloc;
+            self->m_Scratch       = scratch;
+            self->m_OffsetIndex   = 0;
+            self->m_OffsetCount   = 0;
+            self->m_Lexeme.m_Type = kJsonLexInvalid;
+            self->m_ErrorMessage  = nullptr;
+            JsonStructuralInit(&self->m_Structural, buffer, end);
+        }
+
+        void JsonLexerPosition(JsonLexerState const* state, s32& out_line, s32& out_column) { JsonTextPosition(state->m_Text, state->m_Cursor, out_line, out_column); }
+
+        JsonLexeme JsonLexerError(JsonLexerState* state, const char* error)
+        {
+            ASSERT(state->m_ErrorMessage == nullptr);
+            s32 line, column;
+            JsonLexerPosition(state, line, column);
+            int const len         = ascii::strlen(error) + 48;
+            state->m_ErrorMessage = state->m_Scratch->AllocateArray<char>(len + 1);
+            runes_t  errmsg       = ascii::make_runes(state->m_ErrorMessage, state->m_ErrorMessage + len);
+            crunes_t fmt          = ascii::make_crunes("line %d, column %d: %s");
+            sprintf(errmsg, fmt, va_t(line), va_t(column), va_t(error));
+            return JsonLexeme(kJsonLexError);
+        }
+
+        JsonLexeme JsonLexerEof(JsonLexerState* state)
+        {
+            // Drop whatever follows, every following fetch also returns end of file
+            state->m_Cursor              = state->m_End;
+            state->m_Structural.m_Cursor = state->m_End;
+            state->m_OffsetIndex         = state->m_OffsetCount;
+            return JsonLexeme(kJsonLexEof);
+        }
+
+        // Make sure there is at least one unread offset, classifying blocks until one is found
+        static bool JsonLexerFillOffsets(JsonLexerState* state)
+        {
+            while (state->m_OffsetIndex == state->m_OffsetCount)
+            {
+                if (JsonStructuralDone(&state->m_Structural))
+                    return false;
+                state->m_OffsetIndex = 0;
+                state->m_OffsetCount = JsonStructuralNextBlock(&state->m_Structural, state->m_Offsets);
+            }
+            return true;
+        }
+
+        char const* JsonLexerNextToken(JsonLexerState* state)
+        {
+            if (!JsonLexerFillOffsets(state))
+                return nullptr;
+            state->m_Cursor = state->m_Begin + state->m_Offsets[state->m_OffsetIndex++];
+            return state->m_Cursor;
+        }
+
+        char const* JsonLexerSkipContainer(JsonLexerState* state)
+        {
+            ASSERT(kJsonLexInvalid == state->m_Lexeme.m_Type);
+
+            // The structural index does not report brackets inside strings, counting them is enough
+            s32 depth = 1;
+            while (JsonLexerFillOffsets(state))
+            {
+                for (s32 i = state->m_OffsetIndex; i < state->m_OffsetCount; ++i)
+                {
+                    switch (g_JsonTokenClass[(u8)state->m_Begin[state->m_Offsets[i]]])
+                    {
+                        case kJsonTokenBeginObject:
+                        case kJsonTokenBeginArray: depth += 1; break;
+                        case kJsonTokenEndObject:
+                        case kJsonTokenEndArray:
+                            if (--depth == 0)
+                            {
+                                state->m_OffsetIndex = i + 1;
+                                state->m_Cursor      = state->m_Begin + state->m_Offsets[i] + 1;
+                                return state->m_Cursor;
+                            }
+                            break;
+                    }
+                }
+                state->m_OffsetIndex = state->m_OffsetCount;
+            }
+            return nullptr;
+        }
+
+        // End of the token that starts at the current cursor: the start of the next structural with
+        // the whitespace in between trimmed off, or the end of the document.
+        char const* JsonLexerTokenEnd(JsonLexerState* state)
+        {
+            char const* end = state->m_End;
+            if (JsonLexerFillOffsets(state))
+                end = state->m_Begin + state->m_Offsets[state->m_OffsetIndex];
+            while (end > state->m_Cursor && JsonIsWhitespace(end[-1]))
+                --end;
+            return end;
+        }
+
+        char const* JsonLexerStringEnd(JsonLexerState* state)
+        {
+            // The structural index does not report anything inside a string, the closing quote is thus
+            // the last byte of the token, unless the document ended inside the string.
+            char const* end = JsonLexerTokenEnd(state);
+            if (end <= state->m_Cursor + 1 || end[-1] != '"' || (end == state->m_End && JsonStructuralInString(&state->m_Structural)))
+                return nullptr;
+            return end - 1;
+        }
+
+        // ----------------------------------------------------------------------------------------------------------
+        // Strings
+
+        // Unescape [str, end) into 'dst' and NUL terminate it, returns the end of the written string (the
+        // terminator) or nullptr on an illegal escape sequence. An unescaped string is never longer than
+        // its escaped form, 'dst' thus needs room for (end - str + 1) bytes and may be equal to 'str'.
+        static char* JsonUnescape(JsonLexerState* state, char const* str, char const* end, char* dst)
+        {
+            char* const dst_end = dst + (end - str);
+            while (true)
+            {
+                // Move the run of plain characters up to the next backslash or control byte in one go
+                char const* run = JsonFindStringSpecial(str, end);
+                if (dst != str)
+                    nmem::memmove(dst, str, run - str);
+                dst += run - str;
+                str = run;
+
+                if (str == end)
+                    break;
+
+                if ('\\' != *str)
+                {
+                    // Control character, copied as is
+                    *dst++ = *str++;
+                    continue;
+                }
+
+                str += 1;
+                char c = PeekAsciiChar(str, end);
+                str += 1;
+
+                switch (c)
+                {
+                    case '\\': WriteChar('\\', dst, dst_end); break;
+                    case '"': WriteChar('\"', dst, dst_end); break;
+                    case '/': WriteChar('/', dst, dst_end); break;
+                    case 'b': WriteChar('\b', dst, dst_end); break;
+                    case 'f': WriteChar('\f', dst, dst_end); break;
+                    case 'n': WriteChar('\n', dst, dst_end); break;
+                    case 'r': WriteChar('\r', dst, dst_end); break;
+                    case 't': WriteChar('\t', dst, dst_end); break;
+                    case 'u':
+                    {
+                        u32 hex_code = 0;
+                        for (s32 i = 0; i < 4; ++i)
+                        {
+                            c = PeekAsciiChar(str, end);
+                            str += 1;
+
+                            if (nrunes::is_hexa(c))
+                            {
+                                u32 lc = nrunes::to_lower(c);
+                                hex_code <<= 4;
+                                if (lc >= 'a' && lc <= 'f')
+                                    hex_code |= lc - 'a' + 10;
+                                else
+                                    hex_code |= lc - '0';
+                            }
+                            else
+                            {
+                                if (0 == c)
+                                {
+                                    JsonLexerError(state, "end of file inside escape code of json string");
+                                    return nullptr;
+                                }
+                                JsonLexerError(state, "expected 4 character hex number, e.g. '\\uF001'");
+                                return nullptr;
+                            }
+                        }
+                        WriteChar(hex_code, dst, dst_end);
+                        break;
+                    }
+
+                    default:
+                    {
+                        JsonLexerError(state, "unexpected character in string");
+                        return nullptr;
+                    }
+                }
+            }
+
+            *dst = '\0';
+            return dst;
+        }
+
+        char const* JsonLexerUnescapeScratch(JsonLexerState* state, char const* str, char const* end, char const*& out_end)
+        {
+            // Scratch is not committed, the escape sequences are checked the same way
+            char* wptr = state->m_Scratch->Reserve((end - str) + 1);
+            if (wptr == nullptr)
+            {
+                JsonLexerError(state, "out of memory while unescaping string");
+                return nullptr;
+            }
+
+            char* wterm = JsonUnescape(state, str, end, wptr);
+            if (wterm == nullptr)
+                return nullptr;
+            out_end = wterm;
+            return wptr;
+        }
+
+        JsonLexeme JsonStringSpan::Lex(JsonLexerState* state, char const* str, char const* end)
+        {
+            state->m_Cursor = end + 1;
+            return JsonLexeme(kJsonLexString, str, end);
+        }
+
+        JsonLexeme JsonStringCopy::Lex(JsonLexerState* state, char const* str, char const* end)
+        {
+            // The closing quote is known, the room for the unescaped string is checked once up front
+            char* wptr = state->m_Alloc->Reserve((end - str) + 1);
+            if (wptr == nullptr)
+            {
+                // Cancel 'Reserve'
+                return JsonLexerError(state, "out of memory while reading string");
+            }
+
+            char* wterm = JsonUnescape(state, str, end, wptr);
+            if (wterm == nullptr)
+                return JsonLexeme(kJsonLexError); // Cancel 'Reserve'
+
+            state->m_Alloc->Commit(wterm + 1);
+            state->m_Cursor = end + 1;
+            return JsonLexeme(kJsonLexString, wptr, wterm);
+        }
+
+        JsonLexeme JsonStringBorrow::Lex(JsonLexerState* state, char const* str, char const* end)
+        {
+            // A string without escapes can be referenced in the input
+            if (JsonFindStringSpecial(str, end) == end)
+                return JsonStringSpan::Lex(state, str, end);
+            return JsonStringCopy::Lex(state, str, end);
+        }
+
+        JsonLexeme JsonStringInSitu::Lex(JsonLexerState* state, char const* str, char const* end)
+        {
+            // The unescaped string is written over the input, it never grows so the write cursor never
+            // passes the read cursor and the terminator at most replaces the closing quote.
+            char* wptr  = (char*)str;
+            char* wterm = JsonUnescape(state, str, end, wptr);
+            if (wterm == nullptr)
+                return JsonLexeme(kJsonLexError);
+
+            state->m_Cursor = end + 1;
+            return JsonLexeme(kJsonLexString, wptr, wterm);
+        }
+
+        JsonLexeme JsonStringPrefixed::Lex(JsonLexerState* state, char const* str, char const* end)
+        {
+            // The length is known after unescaping, the room for it is reserved in front of the string
+            char* wptr = state->m_Alloc->Reserve((end - str) + sizeof(u32) + 1);
+            if (wptr == nullptr)
+            {
+                // Cancel 'Reserve'
+                return JsonLexerError(state, "out of memory while reading string");
+            }
+
+            char* wstr  = wptr + sizeof(u32);
+            char* wterm = JsonUnescape(state, str, end, wstr);
+            if (wterm == nullptr)
+                return JsonLexeme(kJsonLexError); // Cancel 'Reserve'
+
+            u32 const len = (u32)(wterm - wstr);
+            nmem::memcpy(wptr, &len, sizeof(u32));
+            state->m_Alloc->Commit(wterm + 1);
+            state->m_Cursor = end + 1;
+            return JsonLexeme(kJsonLexString, wstr, wterm);
+        }
+
+        // ----------------------------------------------------------------------------------------------------------
+        // Numbers and literals
+
+        // Literals are ASCII and the token end is known, only the length and the characters need checking
+        static JsonLexemeType JsonLiteralType(char const* str, char const* end, bool& out_value)
+        {
+            s32 const kwlen = (s32)(end - str);
+            if (4 == kwlen)
+            {
+                if (str[0] == 't' && str[1] == 'r' && str[2] == 'u' && str[3] == 'e')
+                {
+                    out_value = true;
+                    return kJsonLexBoolean;
+                }
+                else if (str[0] == 'n' && str[1] == 'u' && str[2] == 'l' && str[3] == 'l')
+                {
+                    return kJsonLexNull;
+                }
+            }
+            else if (5 == kwlen)
+            {
+                if (str[0] == 'f' && str[1] == 'a' && str[2] == 'l' && str[3] == 's' && str[4] == 'e')
+                {
+                    out_value = false;
+                    return kJsonLexBoolean;
+                }
+            }
+            return kJsonLexError;
+        }
+
+        JsonLexeme JsonNumberRaw::Number(JsonLexerState* state, char const* str, char const* end)
+        {
+            state->m_Cursor = end;
+            return JsonLexeme(kJsonLexNumber, str, end);
+        }
+
+        JsonLexeme JsonNumberRaw::Literal(JsonLexerState* state, char const* str, char const* end)
+        {
+            bool                 value = false;
+            JsonLexemeType const type  = JsonLiteralType(str, end, value);
+            if (type == kJsonLexError)
+                return JsonLexerError(state, "invalid literal, expected one of false, true or null");
+
+            state->m_Cursor = end;
+            return JsonLexeme(type, str, end);
+        }
+
+        JsonLexeme JsonNumberConvert::Number(JsonLexerState* state, char const* str, char const* end)
+        {
+            char const* cursor = str;
+            JsonLexeme  result(kJsonLexNumber);
+            if (!ParseNumber(cursor, end, result.m_Number) || cursor != end)
+                return JsonLexerError(state, "illegal number");
+
+            state->m_Cursor = end;
+            return result;
+        }
+
+        JsonLexeme JsonNumberConvert::Literal(JsonLexerState* state, char const* str, char const* end)
+        {
+            bool                 value = false;
+            JsonLexemeType const type  = JsonLiteralType(str, end, value);
+            if (type == kJsonLexError)
+                return JsonLexerError(state, "invalid literal, expected one of false, true or null");
+
+            state->m_Cursor = end;
+            if (type == kJsonLexBoolean)
+                return JsonLexeme(type, JsonNumber(kJsonNumber_bool, value ? 1 : 0));
+            return JsonLexeme(type);
+        }
+
+        JsonLexeme JsonNumberLazy::Number(JsonLexerState* state, char const* str, char const* end) { return JsonNumberRaw::Number(state, str, end); }
+        JsonLexeme JsonNumberLazy::Literal(JsonLexerState* state, char const* str, char const* end) { return JsonNumberConvert::Literal(state, str, end); }
+
+        // ----------------------------------------------------------------------------------------------------------
+        // UTF-8
+
+        bool JsonUtf8Validate::Check(char const* str, char const* end) { return ValidateUtf8(str, end); }
+
+    } // namespace njson
+} // namespace ncore
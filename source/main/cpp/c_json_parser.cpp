@@ -4,262 +4,260 @@
 #include "cbase/c_printf.h"
 #include "cbase/c_runes.h"
 #include "cjson/c_json_parser.h"
-#include "cjson/c_json_parser_lexer.h"
+#include "cjson/c_json_lexer.h"
+#include "cjson/c_json_charclass.h"
 #include "cjson/c_json_utils.h"
 #include "cjson/c_json_allocator.h"
+#include "cjson/c_json_string_pool.h"
 
 namespace ncore
 {
     namespace njson
     {
-        const JsonValue* JsonValue::Find(const char* key) const
+        static inline bool JsonNameEqual(const JsonNamedValue* named_value, const char* key, s32 len, u32 hash)
         {
-            const JsonObjectValue* obj         = AsObject();
-            const JsonNamedValue*  named_value = obj->m_LinkedList;
-            for (int i = 0, count = obj->m_Count; i < count; ++i)
-            {
-                const char* cmp_key = key;
-                const char* obj_key = named_value->m_Name;
-                while (*cmp_key != 0 && *obj_key != 0 && *cmp_key == *obj_key)
-                    ++cmp_key, ++obj_key;
-                if (*cmp_key == 0 && *obj_key == 0)
-                    return named_value->m_Value;
-                named_value = named_value->m_Next;
-            }
-            return nullptr;
+            return named_value->m_Hash == hash && (named_value->m_NameEnd - named_value->m_Name) == len && nmem::memcmp(named_value->m_Name, key, len) == 0;
         }
 
-        struct JsonState
-        {
-            JsonLexerState m_Lexer;
-            char*          m_ErrorMessage;
-            JsonAllocator* m_Allocator;
-            JsonAllocator* m_Scratch;
-            int            m_NumberOfObjects;
-            int            m_NumberOfNumbers;
-            int            m_NumberOfStrings;
-            int            m_NumberOfArrays;
-            int            m_NumberOfBooleans;
-            JsonValue*     m_TrueValue;
-            JsonValue*     m_FalseValue;
-            JsonValue*     m_NullValue;
-        };
+        const JsonValue* JsonValue::Find(const char* key) const { return Find(key, ascii::strlen(key)); }
+
+        const JsonValue* JsonValue::Find(const char* key, s32 len) const { return Find(key, len, JsonHashName(key, key + len)); }
 
-        static void JsonStateInit(JsonState* state, JsonAllocator* alloc, JsonAllocator* scratch, char const* buffer, char const* end)
+        const JsonValue* JsonValue::Find(const char* key, s32 len, u32 hash) const
         {
-            JsonLexerStateInit(&state->m_Lexer, buffer, end, alloc, scratch);
-            state->m_ErrorMessage                            = nullptr;
-            state->m_Allocator                               = alloc;
-            state->m_Scratch                                 = scratch;
-            state->m_NumberOfObjects                         = 0;
-            state->m_NumberOfNumbers                         = 0;
-            state->m_NumberOfStrings                         = 0;
-            state->m_NumberOfArrays                          = 0;
-            state->m_NumberOfBooleans                        = 2;
-            state->m_TrueValue                               = alloc->Allocate<JsonValue>();
-            state->m_TrueValue->m_Type                       = JsonValue::kBoolean;
-            state->m_TrueValue->m_Value.m_Boolean.m_Boolean  = true;
-            state->m_FalseValue                              = alloc->Allocate<JsonValue>();
-            state->m_FalseValue->m_Type                      = JsonValue::kBoolean;
-            state->m_FalseValue->m_Value.m_Boolean.m_Boolean = false;
-            state->m_NullValue                               = alloc->Allocate<JsonValue>();
-            state->m_NullValue->m_Type                       = JsonValue::kNull;
+            const JsonObjectValue* obj = AsObject();
+            if (obj->m_IndexMask != 0)
+            {
+                u32 const* index = (u32 const*)(obj->m_Members + obj->m_Count);
+                for (u32 slot = hash & obj->m_IndexMask; index[slot] != 0; slot = (slot + 1) & obj->m_IndexMask)
+                {
+                    const JsonNamedValue* named_value = &obj->m_Members[index[slot] - 1];
+                    if (JsonNameEqual(named_value, key, len, hash))
+                        return named_value->m_Value;
+                }
+                return nullptr;
+            }
+
+            // Backwards, a duplicate name refers to the member that came last
+            for (s32 i = obj->m_Count - 1; i >= 0; --i)
+            {
+                const JsonNamedValue* named_value = &obj->m_Members[i];
+                if (JsonNameEqual(named_value, key, len, hash))
+                    return named_value->m_Value;
+            }
+            return nullptr;
         }
 
-        static JsonValue* JsonError(JsonState* state, const char* error)
+        const JsonValue* JsonValue::FindPooled(const char* key) const
         {
-            state->m_ErrorMessage = state->m_Scratch->AllocateArray<char>(1024);
-            runes_t  errmsg       = ascii::make_runes(state->m_ErrorMessage, state->m_ErrorMessage + 1024 - 1);
-            crunes_t fmt          = ascii::make_crunes("line %d: %s");
-            ncore::sprintf(errmsg, fmt, va_t(state->m_Lexer.m_LineNumber), va_t(error));
+            const JsonObjectValue* obj = AsObject();
+            for (s32 i = obj->m_Count - 1; i >= 0; --i)
+            {
+                if (obj->m_Members[i].m_Name == key)
+                    return obj->m_Members[i].m_Value;
+            }
             return nullptr;
         }
 
-        static const JsonValue* JsonParseValue(JsonState* json_state);
-
-        static const JsonValue* JsonParseObject(JsonState* json_state)
+        // The elements of an array or the members of an object are collected in scratch, the array of elements
+        // or members is allocated once the count is known
+        struct JsonParseElement
         {
-            JsonLexerState* lexer = &json_state->m_Lexer;
+            const char*       m_Name; // object
+            const char*       m_NameEnd;
+            const JsonValue*  m_Value;
+            JsonParseElement* m_Next;
+        };
 
-            if (!JsonLexerExpect(lexer, kJsonLexBeginObject))
-                return JsonError(json_state, "missing '{'");
+        // An array or object that is being parsed, frames are kept when popped and reused, scratch memory is only
+        // allocated when the document reaches a new depth. A closed container releases the scratch memory of its
+        // elements, including the frames that were first allocated while parsing it.
+        // Nothing that is allocated from 'allocator' is read back while parsing, the container itself is allocated when
+        // it is closed. That is what allows Measure to run the parser with a JsonParseCounter instead.
+        struct JsonParseFrame
+        {
+            JsonParseFrame*   m_Parent;
+            JsonParseFrame*   m_Child;
+            JsonParseFrame*   m_Deepest;   // deepest frame allocated before the container was opened
+            JsonValue*        m_Container; // set when the container is closed
+            JsonParseElement  m_Head;        // m_Head.m_Next is the first element
+            JsonParseElement* m_Tail;        // last element
+            s64               m_ScratchSize; // size of scratch when the container was opened
+            const char*       m_Name;        // object, name of the member whose value is being parsed
+            const char*       m_NameEnd;     // object
+            s32               m_Count;
+            bool              m_IsObject;
+            bool              m_SeenValue;
+            bool              m_SeenComma;
+        };
 
-            JsonAllocatorScope scratch_scope(json_state->m_Scratch);
+        // Measure runs the parser with a counter in place of 'allocator', it follows the alignment of JsonAllocator but has
+        // no memory. A value is written to a sink that every value shares, an array of elements or members is counted as nullptr.
+        struct JsonParseCounter
+        {
+            s64           m_Size;
+            s64           m_Peak;        // capacity of 'allocator', including the room a string needs before it is unescaped
+            s64           m_ScratchPeak; // capacity of 'scratch'
+            JsonParseSize m_Counts;
+            JsonValue     m_Sink;
 
-            bool seen_value = false;
-            bool seen_comma = false;
+            inline s64 Align(s64 size) const { return (size + (s64)sizeof(void*) - 1) & ~((s64)sizeof(void*) - 1); }
 
-            struct KvPair
+            inline void Room(s64 size)
             {
-                const char*      m_Key;
-                const char*      m_KeyEnd;
-                const JsonValue* m_Value;
-                KvPair*          m_Next;
-            };
+                if (Align(m_Size) + size > m_Peak)
+                    m_Peak = Align(m_Size) + size;
+            }
 
-            struct KvPairList
+            inline void Allocate(s64 size)
             {
-                JsonAllocator* m_Scratch;
-                KvPair*        m_Head;
-                KvPair*        m_Tail;
-                s32            m_Count;
+                m_Size = Align(m_Size) + size;
+                if (m_Size > m_Peak)
+                    m_Peak = m_Size;
+            }
+        };
 
-                void Init(JsonAllocator* scratch)
-                {
-                    m_Scratch = scratch;
-                    m_Head    = nullptr;
-                    m_Tail    = nullptr;
-                    m_Count   = 0;
-                }
+        struct JsonState
+        {
+            JsonLexerState    m_Lexer;
+            JsonParseFrame*   m_Top;
+            JsonParseFrame*   m_Frames;  // the frame of depth 1, deeper frames are chained
+            JsonParseFrame*   m_Deepest; // the last frame in the chain
+            s32               m_Depth;
+            s32               m_MaxDepth;
+            bool              m_IndexObjects;
+            JsonStringPool*   m_KeyPool;
+            char*             m_ErrorMessage;
+            JsonAllocator*    m_Allocator;
+            JsonParseCounter* m_Counter; // Measure, instead of m_Allocator
+            JsonAllocator*    m_Scratch;
+            int               m_NumberOfObjects;
+            int               m_NumberOfNumbers;
+            int               m_NumberOfStrings;
+            int               m_NumberOfArrays;
+            int               m_NumberOfBooleans;
+            int               m_NumberOfNames;
+            JsonValue*        m_TrueValue;
+            JsonValue*        m_FalseValue;
+            JsonValue*        m_NullValue;
+        };
 
-                void Add(const char* key, const char* key_end, const JsonValue* value)
-                {
-                    if (1 == ++m_Count)
-                    {
-                        m_Head = m_Tail = m_Scratch->Allocate<KvPair>();
-                        m_Head->m_Key   = key;
-                        m_Head->m_Value = value;
-                        m_Head->m_Next  = nullptr;
-                    }
-                    else
-                    {
-                        KvPair* tail    = m_Tail;
-                        m_Tail          = m_Scratch->Allocate<KvPair>();
-                        m_Tail->m_Key   = key;
-                        m_Tail->m_Value = value;
-                        m_Tail->m_Next  = nullptr;
-                        tail->m_Next    = m_Tail;
-                    }
-                }
-            };
+        // ----------------------------------------------------------------------------------------------------------
+        // Parse allocates the document from m_Allocator, Measure runs the same code with JsonMeasurePolicy and only
+        // counts. The choice is made by the policy at compile time, Parse has no counting in it.
 
-            // KvPairList kv_pairs;
-            // kv_pairs.Init(json_state->m_Scratch);
+        // Strings are lexed as spans, what the string policy of Parse (TString) would copy is counted instead
+        template <typename TString, typename TNumber, typename TUtf8> struct JsonMeasurePolicy
+        {
+            typedef JsonStringSpan String;
+            typedef TNumber        Number;
+            typedef TUtf8          Utf8;
+            typedef TString        Copy;
+        };
 
-            JsonAllocator* alloc  = json_state->m_Allocator;
-            JsonValue*     result = alloc->Allocate<JsonValue>();
-            result->m_Type        = JsonValue::kObject;
+        static inline bool JsonMeasureCopies(bool, JsonStringCopy const*) { return true; }
+        static inline bool JsonMeasureCopies(bool escaped, JsonStringBorrow const*) { return escaped; }
 
-            result->m_Value.m_Object.m_Count      = 0;
-            result->m_Value.m_Object.m_LinkedList = nullptr;
+        template <typename P> struct JsonParseAlloc
+        {
+            static inline JsonValue* Value(JsonState* state) { return state->m_Allocator->Allocate<JsonValue>(); }
+            static inline char*      Array(JsonState* state, s64 size) { return state->m_Allocator->Allocate(size, sizeof(void*)); }
+            static inline bool       String(JsonState*, JsonLexeme const&) { return true; } // copied by the lexer
+            static inline void       Scratch(JsonState*, s64) {}
+        };
 
-            bool done = false;
-            while (!done)
+        template <typename TString, typename TNumber, typename TUtf8> struct JsonParseAlloc<JsonMeasurePolicy<TString, TNumber, TUtf8> >
+        {
+            static inline JsonValue* Value(JsonState* state)
             {
-                JsonLexeme l = JsonLexerNext(lexer);
-
-                switch (l.m_Type)
-                {
-                    case kJsonLexString:
-                    {
-                        if (seen_value && !seen_comma)
-                            return JsonError(json_state, "missing ','");
-
-                        if (!JsonLexerExpect(lexer, kJsonLexNameSeparator))
-                            return JsonError(json_state, "missing ':'");
-
-                        const JsonValue* value = JsonParseValue(json_state);
-
-                        if (value == nullptr)
-                            return nullptr;
-
-                        JsonNamedValue* named_value           = alloc->Allocate<JsonNamedValue>();
-                        named_value->m_Name                   = l.m_String.m_Str;
-                        named_value->m_Value                  = value;
-                        named_value->m_Next                   = result->m_Value.m_Object.m_LinkedList;
-                        result->m_Value.m_Object.m_LinkedList = named_value;
-                        result->m_Value.m_Object.m_Count += 1;
-
-                        seen_value = true;
-                        seen_comma = false;
-                    }
-                    break;
-
-                    case kJsonLexEndObject: done = true; break;
-
-                    case kJsonLexValueSeparator:
-                    {
-                        if (!seen_value)
-                            return JsonError(json_state, "expected key name");
-
-                        if (seen_comma)
-                            return JsonError(json_state, "duplicate comma");
-
-                        seen_value = false;
-                        seen_comma = true;
-                        break;
-                    }
-
-                    default: return JsonError(json_state, "expected object to continue");
-                }
+                state->m_Counter->Allocate(sizeof(JsonValue));
+                return &state->m_Counter->m_Sink;
             }
 
-            json_state->m_NumberOfObjects += 1;
-            return result;
-        }
-
-        static const JsonValue* JsonParseArray(JsonState* json_state)
-        {
-            JsonLexerState* lexer = &json_state->m_Lexer;
-
-            if (!JsonLexerExpect(lexer, kJsonLexBeginArray))
-                return JsonError(json_state, "expected '['");
-
-            JsonAllocator* alloc = json_state->m_Allocator;
-
-            JsonValue* result                    = alloc->Allocate<JsonValue>();
-            result->m_Type                       = JsonValue::kArray;
-            result->m_Value.m_Array.m_Count      = 0;
-            result->m_Value.m_Array.m_LinkedList = nullptr;
-
-            i32              count = 0;
-            JsonLinkedValue* head  = nullptr;
-            JsonLinkedValue* tail  = nullptr;
-            for (;;)
+            static inline char* Array(JsonState* state, s64 size)
             {
-                JsonLexeme l = JsonLexerPeek(lexer);
-
-                if (kJsonLexEndArray == l.m_Type)
-                {
-                    JsonLexerSkip(lexer);
-                    break;
-                }
+                state->m_Counter->Allocate(size);
+                return nullptr;
+            }
 
-                if (count > 0)
+            // The room for the escaped string is needed up front, an escaped string is unescaped into scratch for its length
+            static bool String(JsonState* state, JsonLexeme const& l)
+            {
+                char const* str     = l.m_String.m_Str;
+                char const* end     = str + l.m_String.m_Len;
+                bool const  escaped = JsonFindStringSpecial(str, end) != end;
+                if (!JsonMeasureCopies(escaped, (TString const*)nullptr))
+                    return true;
+
+                JsonParseCounter* counter = state->m_Counter;
+                counter->Room((end - str) + 1);
+                if (escaped)
                 {
-                    if (kJsonLexValueSeparator != l.m_Type)
-                    {
-                        return JsonError(json_state, "expected ','");
-                    }
-
-                    JsonLexerSkip(lexer);
+                    str = JsonLexerUnescapeScratch(&state->m_Lexer, l.m_String.m_Str, end, end);
+                    if (str == nullptr)
+                        return false;
                 }
+                counter->Allocate((end - str) + 1);
+                counter->m_Counts.m_StringBytes += (end - str) + 1;
+                return true;
+            }
 
-                const JsonValue* value = JsonParseValue(json_state);
-                if (!value)
-                    return nullptr;
-
-                JsonLinkedValue* linked_value = alloc->Allocate<JsonLinkedValue>();
-                linked_value->m_Value         = value;
-                linked_value->m_Next          = nullptr;
-                if (count == 0)
-                {
-                    head = tail = linked_value;
-                }
-                else
-                {
-                    tail->m_Next = linked_value;
-                    tail         = linked_value;
-                }
-                count += 1;
+            // Scratch has grown, 'room' is what a reservation needs on top of it
+            static inline void Scratch(JsonState* state, s64 room)
+            {
+                JsonAllocator const* scratch = state->m_Scratch;
+                s64 const            size    = room > 0 ? ((scratch->m_Size + (s64)sizeof(void*) - 1) & ~((s64)sizeof(void*) - 1)) + room : scratch->m_Size;
+                if (size > state->m_Counter->m_ScratchPeak)
+                    state->m_Counter->m_ScratchPeak = size;
             }
+        };
 
-            result->m_Value.m_Array.m_Count      = count;
-            result->m_Value.m_Array.m_LinkedList = head;
+        template <typename P> static void JsonStateInit(JsonState* state, JsonAllocator* alloc, JsonParseCounter* counter, JsonAllocator* scratch, char const* buffer, char const* end, JsonParseOptions const& options)
+        {
+            JsonLexerStateInit(&state->m_Lexer, buffer, end, alloc, scratch);
+            state->m_Top                                     = nullptr;
+            state->m_Frames                                  = nullptr;
+            state->m_Deepest                                 = nullptr;
+            state->m_Depth                                   = 0;
+            state->m_MaxDepth                                = options.m_MaxDepth;
+            state->m_IndexObjects                            = (options.m_Flags & kJsonParseIndexObjects) != 0;
+            state->m_KeyPool                                 = options.m_KeyPool;
+            state->m_ErrorMessage                            = nullptr;
+            state->m_Allocator                               = alloc;
+            state->m_Counter                                 = counter;
+            state->m_Scratch                                 = scratch;
+            state->m_NumberOfObjects                         = 0;
+            state->m_NumberOfNumbers                         = 0;
+            state->m_NumberOfStrings                         = 0;
+            state->m_NumberOfArrays                          = 0;
+            state->m_NumberOfBooleans                        = 2;
+            state->m_NumberOfNames                           = 0;
+            state->m_TrueValue                               = JsonParseAlloc<P>::Value(state);
+            state->m_TrueValue->m_Type                       = JsonValue::kBoolean;
+            state->m_TrueValue->m_Value.m_Boolean.m_Boolean  = true;
+            state->m_FalseValue                              = JsonParseAlloc<P>::Value(state);
+            state->m_FalseValue->m_Type                      = JsonValue::kBoolean;
+            state->m_FalseValue->m_Value.m_Boolean.m_Boolean = false;
+            state->m_NullValue                               = JsonParseAlloc<P>::Value(state);
+            state->m_NullValue->m_Type                       = JsonValue::kNull;
+        }
 
-            json_state->m_NumberOfArrays += 1;
+        static JsonValue* JsonError(JsonState* state, const char* error)
+        {
+            // An error of the lexer is the cause, its message and position are kept
+            if (state->m_Lexer.m_ErrorMessage != nullptr)
+            {
+                state->m_ErrorMessage = state->m_Lexer.m_ErrorMessage;
+                return nullptr;
+            }
 
-            return result;
+            state->m_ErrorMessage = state->m_Scratch->AllocateArray<char>(1024);
+            runes_t  errmsg       = ascii::make_runes(state->m_ErrorMessage, state->m_ErrorMessage + 1024 - 1);
+            crunes_t fmt          = ascii::make_crunes("line %d, column %d: %s");
+            s32      line, column;
+            JsonLexerPosition(&state->m_Lexer, line, column);
+            ncore::sprintf(errmsg, fmt, va_t(line), va_t(column), va_t(error));
+            return nullptr;
         }
 
         bool JsonValue::GetColor(u32& out_color) const
@@ -309,72 +307,435 @@ namespace ncore
             return true;
         }
 
-        static const JsonValue* JsonParseValue(JsonState* json_state)
+        enum EJsonParseStep
+        {
+            kJsonParseStepValue, // the container expects a value
+            kJsonParseStepDone,  // the container is closed
+            kJsonParseStepError,
+        };
+
+        // The number policy of the lexer decides what is stored, the exact number or its text
+        static inline void JsonNumberValueInit(JsonNumberValue& number, JsonLexeme const& l, JsonNumberConvert const*)
+        {
+            number.m_NumberType = l.m_Number.m_Type;
+            number.m_TextLen    = 0;
+            number.m_U64        = l.m_Number.m_U64;
+        }
+
+        static inline void JsonNumberValueInit(JsonNumberValue& number, JsonLexeme const& l, JsonNumberLazy const*)
+        {
+            number.m_NumberType = kJsonNumber_unknown;
+            number.m_TextLen    = l.m_String.m_Len;
+            number.m_Text       = l.m_String.m_Str;
+        }
+
+        JsonNumber JsonNumberValueResolve(JsonNumberValue const* number)
+        {
+            if (number->m_NumberType == kJsonNumber_unknown)
+            {
+                JsonNumber  value;
+                char const* str = number->m_Text;
+                char const* end = str + number->m_TextLen;
+                if (!ParseNumber(str, end, value) || str != end)
+                    return JsonNumber(); // the text is kept, every call reports it
+
+                JsonNumberValue* resolved = const_cast<JsonNumberValue*>(number);
+                resolved->m_NumberType    = value.m_Type;
+                resolved->m_TextLen       = 0;
+                resolved->m_U64           = value.m_U64;
+            }
+            return JsonNumber((JsonNumberType)number->m_NumberType, number->m_S64);
+        }
+
+        template <typename P> static const JsonValue* JsonParseScalar(JsonState* json_state, JsonLexeme const& l)
         {
             const JsonValue* result = nullptr;
-            JsonLexeme       l      = JsonLexerPeek(&json_state->m_Lexer);
             switch (l.m_Type)
             {
-                case kJsonLexBeginObject: result = JsonParseObject(json_state); break;
-                case kJsonLexBeginArray: result = JsonParseArray(json_state); break;
-
                 case kJsonLexString:
                 {
                     json_state->m_NumberOfStrings += 1;
-                    JsonValue* sv                 = json_state->m_Allocator->Allocate<JsonValue>();
+                    if (!JsonParseAlloc<P>::String(json_state, l))
+                        return JsonError(json_state, "invalid string");
+                    JsonValue* sv                 = JsonParseAlloc<P>::Value(json_state);
                     sv->m_Type                    = JsonValue::kString;
                     sv->m_Value.m_String.m_String = l.m_String.m_Str;
                     sv->m_Value.m_String.m_End    = l.m_String.m_Str + l.m_String.m_Len;
                     result                        = sv;
-                    JsonLexerSkip(&json_state->m_Lexer);
                     break;
                 }
 
                 case kJsonLexNumber:
                 {
                     json_state->m_NumberOfNumbers += 1;
-                    JsonValue* nv                     = json_state->m_Allocator->Allocate<JsonValue>();
-                    nv->m_Type                        = JsonValue::kNumber;
-                    nv->m_Value.m_Number.m_NumberType = l.m_Number.m_Type;
-                    nv->m_Value.m_Number.m_F64        = JsonNumberAsFloat64(l.m_Number);
-                    result                            = nv;
-                    JsonLexerSkip(&json_state->m_Lexer);
+                    JsonValue* nv = JsonParseAlloc<P>::Value(json_state);
+                    nv->m_Type    = JsonValue::kNumber;
+                    JsonNumberValueInit(nv->m_Value.m_Number, l, (typename P::Number const*)nullptr);
+                    result = nv;
                     break;
                 }
 
-                case kJsonLexBoolean:
-                    result = l.m_Number.m_S64 != 0 ? json_state->m_TrueValue : json_state->m_FalseValue;
-                    JsonLexerSkip(&json_state->m_Lexer);
-                    break;
+                case kJsonLexBoolean: result = l.m_Number.m_S64 != 0 ? json_state->m_TrueValue : json_state->m_FalseValue; break;
+                case kJsonLexNull: result = json_state->m_NullValue; break;
 
-                case kJsonLexNull:
-                    result = json_state->m_NullValue;
-                    JsonLexerSkip(&json_state->m_Lexer);
-                    break;
+                case kJsonLexError: return JsonError(json_state, json_state->m_Lexer.m_ErrorMessage);
 
-                default: result = JsonError(json_state, "invalid document"); break;
+                default: return JsonError(json_state, "invalid document");
             }
 
+            JsonLexerSkip<P>(&json_state->m_Lexer);
             return result;
         }
 
+        static bool JsonParsePush(JsonState* json_state, JsonValue::Type type)
+        {
+            if (json_state->m_Depth == json_state->m_MaxDepth)
+                return false;
+
+            // Frames are chained by depth, the frame of a depth that was reached before is reused
+            JsonParseFrame* top   = json_state->m_Top;
+            JsonParseFrame* frame = top != nullptr ? top->m_Child : json_state->m_Frames;
+            if (frame == nullptr)
+            {
+                frame           = json_state->m_Scratch->Allocate<JsonParseFrame>();
+                frame->m_Parent = top;
+                frame->m_Child  = nullptr;
+                if (top != nullptr)
+                    top->m_Child = frame;
+                else
+                    json_state->m_Frames = frame;
+                json_state->m_Deepest = frame;
+            }
+
+            frame->m_Container   = nullptr;
+            frame->m_IsObject    = type == JsonValue::kObject;
+            frame->m_Count       = 0;
+            frame->m_Deepest     = json_state->m_Deepest;
+            frame->m_ScratchSize = json_state->m_Scratch->m_Size;
+            frame->m_Head.m_Next = nullptr;
+            frame->m_Tail        = &frame->m_Head;
+            frame->m_Name        = nullptr;
+            frame->m_NameEnd     = nullptr;
+            frame->m_SeenValue   = false;
+            frame->m_SeenComma   = false;
+            json_state->m_Top    = frame;
+            json_state->m_Depth += 1;
+            return true;
+        }
+
+        static void JsonParsePop(JsonState* json_state)
+        {
+            // Release the scratch memory of the container, frames allocated after it was opened are gone as well
+            JsonParseFrame* frame          = json_state->m_Top;
+            json_state->m_Scratch->m_Size  = frame->m_ScratchSize;
+            json_state->m_Deepest          = frame->m_Deepest;
+            json_state->m_Deepest->m_Child = nullptr;
+
+            json_state->m_Top = frame->m_Parent;
+            json_state->m_Depth -= 1;
+        }
+
+        // Members are inserted in document order, a duplicate name takes over the slot so that the last one is found
+        static void JsonBuildObjectIndex(JsonNamedValue const* members, s32 count, u32* index, u32 mask)
+        {
+            nmem::memset(index, 0, sizeof(u32) * (mask + 1));
+            for (s32 i = 0; i < count; ++i)
+            {
+                JsonNamedValue const* member = &members[i];
+                u32                   slot   = member->m_Hash & mask;
+                while (index[slot] != 0 && !JsonNameEqual(&members[index[slot] - 1], member->m_Name, (s32)(member->m_NameEnd - member->m_Name), member->m_Hash))
+                    slot = (slot + 1) & mask;
+                index[slot] = (u32)(i + 1);
+            }
+        }
+
+        // With a key pool member names are lexed as spans of the input, see JsonParseNamePolicy. A name that is in the pool, or is
+        // added to it, is never copied. An escaped name is unescaped into scratch for the lookup. A name that does not fit in the pool
+        // is delivered by the string policy of the document, as if there was no pool.
+        template <typename P> struct JsonParseNamePolicy
+        {
+            typedef JsonLexerPolicy<JsonStringSpan, typename P::Number, typename P::Utf8> Policy;
+        };
+
+        template <typename P> static bool JsonParsePoolName(JsonState* json_state, JsonParseFrame* frame, JsonLexeme const& l)
+        {
+            JsonLexerState* lexer    = &json_state->m_Lexer;
+            char const*     str      = l.m_String.m_Str;
+            char const*     end      = str + l.m_String.m_Len;
+            char const*     name     = str;
+            char const*     name_end = end;
+            if (JsonFindStringSpecial(str, end) != end)
+            {
+                JsonParseAlloc<P>::Scratch(json_state, (end - str) + 1);
+                name = JsonLexerUnescapeScratch(lexer, str, end, name_end);
+                if (name == nullptr)
+                    return false;
+            }
+
+            const char* pooled = json_state->m_KeyPool->Intern(name, name_end);
+            if (pooled != nullptr)
+            {
+                frame->m_Name    = pooled;
+                frame->m_NameEnd = pooled + (name_end - name);
+                return true;
+            }
+
+            JsonLexeme const copy = P::String::Lex(lexer, str, end);
+            if (copy.m_Type != kJsonLexString || !JsonParseAlloc<P>::String(json_state, copy))
+                return false;
+            frame->m_Name    = copy.m_String.m_Str;
+            frame->m_NameEnd = copy.m_String.m_Str + copy.m_String.m_Len;
+            return true;
+        }
+
+        // Add 'value' (if any) as the member that was named before and read up to the next member value or the end of the object
+        template <typename P> static EJsonParseStep JsonParseObjectStep(JsonState* json_state, JsonParseFrame* frame, const JsonValue* value)
+        {
+            JsonLexerState* lexer = &json_state->m_Lexer;
+
+            if (value != nullptr)
+            {
+                JsonParseElement* element = json_state->m_Scratch->Allocate<JsonParseElement>();
+                JsonParseAlloc<P>::Scratch(json_state, 0);
+                element->m_Name           = frame->m_Name;
+                element->m_NameEnd        = frame->m_NameEnd;
+                element->m_Value          = value;
+                element->m_Next           = nullptr;
+                frame->m_Tail->m_Next     = element;
+                frame->m_Tail             = element;
+                frame->m_Count += 1;
+
+                frame->m_SeenValue = true;
+                frame->m_SeenComma = false;
+            }
+
+            for (;;)
+            {
+                JsonLexeme l = json_state->m_KeyPool != nullptr ? JsonLexerNext<typename JsonParseNamePolicy<P>::Policy>(lexer) : JsonLexerNext<P>(lexer);
+
+                switch (l.m_Type)
+                {
+                    case kJsonLexString:
+                    {
+                        if (frame->m_SeenValue && !frame->m_SeenComma)
+                        {
+                            JsonError(json_state, "missing ','");
+                            return kJsonParseStepError;
+                        }
+
+                        frame->m_Name    = l.m_String.m_Str;
+                        frame->m_NameEnd = l.m_String.m_Str + l.m_String.m_Len;
+                        if (json_state->m_KeyPool != nullptr ? !JsonParsePoolName<P>(json_state, frame, l) : !JsonParseAlloc<P>::String(json_state, l))
+                        {
+                            JsonError(json_state, "invalid member name");
+                            return kJsonParseStepError;
+                        }
+
+                        json_state->m_NumberOfNames += 1;
+
+                        if (!JsonLexerExpect<P>(lexer, kJsonLexNameSeparator))
+                        {
+                            JsonError(json_state, "missing ':'");
+                            return kJsonParseStepError;
+                        }
+                        return kJsonParseStepValue;
+                    }
+
+                    case kJsonLexEndObject:
+                    {
+                        // The final count is known, the members move from scratch into one contiguous array
+                        s32 const       count   = frame->m_Count;
+                        JsonNamedValue* members = nullptr;
+                        u32             slots   = 0;
+                        if (count > 0)
+                        {
+                            if (json_state->m_IndexObjects && count >= kJsonObjectIndexMinMembers)
+                            {
+                                slots = 2 * kJsonObjectIndexMinMembers;
+                                while (slots < (u32)(2 * count))
+                                    slots <<= 1;
+                            }
+
+                            // nullptr when measuring, there is nothing to fill in
+                            members = (JsonNamedValue*)JsonParseAlloc<P>::Array(json_state, sizeof(JsonNamedValue) * count + sizeof(u32) * slots);
+                            if (members != nullptr)
+                            {
+                                JsonParseElement* element = frame->m_Head.m_Next;
+                                for (s32 i = 0; i < count; ++i)
+                                {
+                                    members[i].m_Name    = element->m_Name;
+                                    members[i].m_NameEnd = element->m_NameEnd;
+                                    members[i].m_Value   = element->m_Value;
+                                    members[i].m_Hash    = JsonHashName(element->m_Name, element->m_NameEnd);
+                                    element              = element->m_Next;
+                                }
+
+                                if (slots > 0)
+                                    JsonBuildObjectIndex(members, count, (u32*)(members + count), slots - 1);
+                            }
+                        }
+
+                        JsonValue* result                    = JsonParseAlloc<P>::Value(json_state);
+                        result->m_Type                       = JsonValue::kObject;
+                        result->m_Value.m_Object.m_Count     = count;
+                        result->m_Value.m_Object.m_IndexMask = slots > 0 ? slots - 1 : 0;
+                        result->m_Value.m_Object.m_Members   = members;
+                        frame->m_Container                   = result;
+                        json_state->m_NumberOfObjects += 1;
+                        return kJsonParseStepDone;
+                    }
+
+                    case kJsonLexValueSeparator:
+                    {
+                        if (!frame->m_SeenValue)
+                        {
+                            JsonError(json_state, "expected key name");
+                            return kJsonParseStepError;
+                        }
+
+                        if (frame->m_SeenComma)
+                        {
+                            JsonError(json_state, "duplicate comma");
+                            return kJsonParseStepError;
+                        }
+
+                        frame->m_SeenValue = false;
+                        frame->m_SeenComma = true;
+                        break;
+                    }
+
+                    case kJsonLexError: JsonError(json_state, json_state->m_Lexer.m_ErrorMessage); return kJsonParseStepError;
+
+                    default: JsonError(json_state, "expected object to continue"); return kJsonParseStepError;
+                }
+            }
+        }
+
+        // Append 'value' (if any) and read up to the next element or the end of the array
+        template <typename P> static EJsonParseStep JsonParseArrayStep(JsonState* json_state, JsonParseFrame* frame, const JsonValue* value)
+        {
+            JsonLexerState* lexer = &json_state->m_Lexer;
+
+            if (value != nullptr)
+            {
+                JsonParseElement* element = json_state->m_Scratch->Allocate<JsonParseElement>();
+                JsonParseAlloc<P>::Scratch(json_state, 0);
+                element->m_Name           = nullptr;
+                element->m_NameEnd        = nullptr;
+                element->m_Value          = value;
+                element->m_Next           = nullptr;
+                frame->m_Tail->m_Next     = element;
+                frame->m_Tail             = element;
+                frame->m_Count += 1;
+            }
+
+            JsonLexeme l = JsonLexerPeek<P>(lexer);
+
+            if (kJsonLexEndArray == l.m_Type)
+            {
+                JsonLexerSkip<P>(lexer);
+
+                // The final count is known, the elements move from scratch into one contiguous array
+                s32 const         count  = frame->m_Count;
+                const JsonValue** values = nullptr;
+                if (count > 0)
+                {
+                    // nullptr when measuring, there is nothing to fill in
+                    values = (const JsonValue**)JsonParseAlloc<P>::Array(json_state, sizeof(const JsonValue*) * count);
+                    if (values != nullptr)
+                    {
+                        JsonParseElement* element = frame->m_Head.m_Next;
+                        for (s32 i = 0; i < count; ++i)
+                        {
+                            values[i] = element->m_Value;
+                            element   = element->m_Next;
+                        }
+                    }
+                }
+
+                JsonValue* result                = JsonParseAlloc<P>::Value(json_state);
+                result->m_Type                   = JsonValue::kArray;
+                result->m_Value.m_Array.m_Count  = count;
+                result->m_Value.m_Array.m_Values = values;
+                frame->m_Container               = result;
+                json_state->m_NumberOfArrays += 1;
+                return kJsonParseStepDone;
+            }
+
+            if (frame->m_Count > 0)
+            {
+                if (kJsonLexValueSeparator != l.m_Type)
+                {
+                    JsonError(json_state, "expected ','");
+                    return kJsonParseStepError;
+                }
+
+                JsonLexerSkip<P>(lexer);
+            }
+
+            return kJsonParseStepValue;
+        }
+
+        // Iterative, nested arrays and objects are frames on an explicit stack instead of recursive calls
+        template <typename P> static const JsonValue* JsonParseValue(JsonState* json_state)
+        {
+            JsonLexerState* lexer = &json_state->m_Lexer;
+            for (;;)
+            {
+                // A value, either a scalar or the start of an array or object
+                const JsonValue* value = nullptr;
+                JsonLexeme       l     = JsonLexerPeek<P>(lexer);
+                if (kJsonLexBeginObject == l.m_Type || kJsonLexBeginArray == l.m_Type)
+                {
+                    if (!JsonParsePush(json_state, kJsonLexBeginObject == l.m_Type ? JsonValue::kObject : JsonValue::kArray))
+                        return JsonError(json_state, "maximum nesting depth exceeded");
+                    JsonParseAlloc<P>::Scratch(json_state, 0);
+                    JsonLexerSkip<P>(lexer);
+                }
+                else
+                {
+                    value = JsonParseScalar<P>(json_state, l);
+                    if (value == nullptr)
+                        return nullptr;
+                }
+
+                // Add the value to its container, closing containers until one expects another value
+                while (json_state->m_Top != nullptr)
+                {
+                    JsonParseFrame* frame = json_state->m_Top;
+                    EJsonParseStep  step  = frame->m_IsObject ? JsonParseObjectStep<P>(json_state, frame, value) : JsonParseArrayStep<P>(json_state, frame, value);
+                    if (step == kJsonParseStepError)
+                        return nullptr;
+                    if (step == kJsonParseStepValue)
+                        break;
+
+                    value = frame->m_Container;
+                    JsonParsePop(json_state);
+                }
+
+                if (json_state->m_Top == nullptr)
+                    return value;
+            }
+        }
+
         const JsonValue* Parse(char const* str, char const* end, JsonAllocator* allocator, JsonAllocator* scratch, char const*& error_message)
+        {
+            JsonParseOptions options;
+            return Parse(str, end, allocator, scratch, options, error_message);
+        }
+
+        template <typename P> static const JsonValue* JsonParseDocument(char const* str, char const* end, JsonAllocator* allocator, JsonParseCounter* counter, JsonAllocator* scratch, JsonParseOptions const& options, char const*& error_message)
         {
             JsonState* json_state = scratch->Allocate<JsonState>();
-            JsonStateInit(json_state, allocator, scratch, str, end);
+            JsonStateInit<P>(json_state, allocator, counter, scratch, str, end, options);
+            JsonParseAlloc<P>::Scratch(json_state, 0);
 
-            const JsonValue* root = JsonParseValue(json_state);
-            if (root && !JsonLexerExpect(&json_state->m_Lexer, kJsonLexEof))
+            const JsonValue* root = JsonParseValue<P>(json_state);
+            if (root && !JsonLexerExpect<P>(&json_state->m_Lexer, kJsonLexEof))
             {
                 root = JsonError(json_state, "data after document");
             }
 
-            // Mainly to reduce the duplication of keys (strings) but in some way also string values.
-            // We could benefit from an additional 2 allocators that are used for:
-            // - [Hash 32-bit, String Offset 32-bit] pairs (sorted)
-            // - Strings (UTF-8 strings)
-            // The user could even pre-warm these with known strings and even reuse them between different JSON documents.
-
             error_message = nullptr;
             if (!root)
             {
@@ -384,7 +745,106 @@ namespace ncore
                 errmsg[len]   = '\0';
                 error_message = errmsg;
             }
+            else if (counter != nullptr)
+            {
+                counter->m_Counts.m_NumberOfObjects = json_state->m_NumberOfObjects;
+                counter->m_Counts.m_NumberOfArrays  = json_state->m_NumberOfArrays;
+                counter->m_Counts.m_NumberOfNumbers = json_state->m_NumberOfNumbers;
+                counter->m_Counts.m_NumberOfStrings = json_state->m_NumberOfStrings;
+                counter->m_Counts.m_NumberOfNames   = json_state->m_NumberOfNames;
+            }
+
+            return root;
+        }
+
+        // The options select a lexer instantiation once, the lexer itself does not branch on them. TPolicy is JsonLexerPolicy
+        // to parse and JsonMeasurePolicy to measure.
+        template <template <typename, typename, typename> class TPolicy, typename TString, typename TUtf8>
+        static const JsonValue* JsonParseWithOptions(char const* str, char const* end, JsonAllocator* allocator, JsonParseCounter* counter, JsonAllocator* scratch, JsonParseOptions const& options, char const*& error_message)
+        {
+            if (options.m_Flags & kJsonParseLazyNumbers)
+                return JsonParseDocument<TPolicy<TString, JsonNumberLazy, TUtf8> >(str, end, allocator, counter, scratch, options, error_message);
+            return JsonParseDocument<TPolicy<TString, JsonNumberConvert, TUtf8> >(str, end, allocator, counter, scratch, options, error_message);
+        }
+
+        template <template <typename, typename, typename> class TPolicy>
+        static const JsonValue* JsonParseWithFlags(char const* str, char const* end, JsonAllocator* allocator, JsonParseCounter* counter, JsonAllocator* scratch, JsonParseOptions const& options, char const*& error_message)
+        {
+            bool const validate = (options.m_Flags & kJsonParseValidateUtf8) != 0;
+            if (options.m_Flags & kJsonParseBorrowStrings)
+            {
+                if (validate)
+                    return JsonParseWithOptions<TPolicy, JsonStringBorrow, JsonUtf8Validate>(str, end, allocator, counter, scratch, options, error_message);
+                return JsonParseWithOptions<TPolicy, JsonStringBorrow, JsonUtf8Trust>(str, end, allocator, counter, scratch, options, error_message);
+            }
+            if (validate)
+                return JsonParseWithOptions<TPolicy, JsonStringCopy, JsonUtf8Validate>(str, end, allocator, counter, scratch, options, error_message);
+            return JsonParseWithOptions<TPolicy, JsonStringCopy, JsonUtf8Trust>(str, end, allocator, counter, scratch, options, error_message);
+        }
+
+        const JsonValue* Parse(char const* str, char const* end, JsonAllocator* allocator, JsonAllocator* scratch, JsonParseOptions const& options, char const*& error_message)
+        {
+            return JsonParseWithFlags<JsonLexerPolicy>(str, end, allocator, nullptr, scratch, options, error_message);
+        }
+
+        const JsonValue* ParseInSitu(char* str, char* end, JsonAllocator* allocator, JsonAllocator* scratch, char const*& error_message)
+        {
+            JsonParseOptions options;
+            return ParseInSitu(str, end, allocator, scratch, options, error_message);
+        }
+
+        const JsonValue* ParseInSitu(char* str, char* end, JsonAllocator* allocator, JsonAllocator* scratch, JsonParseOptions const& options, char const*& error_message)
+        {
+            if (options.m_Flags & kJsonParseValidateUtf8)
+                return JsonParseWithOptions<JsonLexerPolicy, JsonStringInSitu, JsonUtf8Validate>(str, end, allocator, nullptr, scratch, options, error_message);
+            return JsonParseWithOptions<JsonLexerPolicy, JsonStringInSitu, JsonUtf8Trust>(str, end, allocator, nullptr, scratch, options, error_message);
+        }
+
+        // ----------------------------------------------------------------------------------------------------------
+        // Measure runs the parser itself with JsonMeasurePolicy, every allocation that Parse makes is counted with the
+        // same size and alignment. Scratch is used as it is by Parse, its peak is the scratch size.
+
+        bool Measure(char const* str, char const* end, JsonAllocator* scratch, JsonParseSize& size, char const*& error_message)
+        {
+            JsonParseOptions options;
+            return Measure(str, end, scratch, options, size, error_message);
+        }
+
+        bool Measure(char const* str, char const* end, JsonAllocator* scratch, JsonParseOptions const& options, JsonParseSize& size, char const*& error_message)
+        {
+            s64 const        scratch_size = scratch->m_Size;
+            JsonParseCounter counter;
+            nmem::memset(&counter, 0, sizeof(JsonParseCounter));
+            counter.m_ScratchPeak = scratch_size;
+
+            const JsonValue* root = JsonParseWithFlags<JsonMeasurePolicy>(str, end, nullptr, &counter, scratch, options, error_message);
+            if (root != nullptr)
+            {
+                counter.m_Counts.m_AllocatorSize = counter.m_Peak;
+                counter.m_Counts.m_ScratchSize   = counter.m_ScratchPeak - scratch_size;
+                scratch->m_Size                  = scratch_size;
+            }
+
+            size = counter.m_Counts;
+            return root != nullptr;
+        }
+
+        const JsonValue* ParseExact(char const* str, char const* end, alloc_t* alloc, JsonAllocator* allocator, JsonAllocator* scratch, JsonParseOptions const& options, char const*& error_message)
+        {
+            JsonParseSize size;
+            if (!Measure(str, end, scratch, options, size, error_message))
+                return nullptr;
+
+            if ((scratch->m_Capacity - scratch->m_Size) < size.m_ScratchSize)
+            {
+                error_message = "scratch is too small to parse the document";
+                return nullptr;
+            }
 
+            allocator->Init(alloc, size.m_AllocatorSize, "json_document");
+            const JsonValue* root = Parse(str, end, allocator, scratch, options, error_message);
+            if (root == nullptr)
+                allocator->Destroy();
             return root;
         }
 
@@ -0,0 +1,156 @@
+#include "cbase/c_allocator.h"
+#include "cbase/c_memory.h"
+#include "cbase/c_printf.h"
+#include "cbase/c_runes.h"
+#include "cjson/c_json_utils.h"
+#include "cjson/c_json_allocator.h"
+#include "cjson/c_json_pointer.h"
+
+namespace ncore
+{
+    namespace njson
+    {
+        static const JsonPointer* JsonPointerError(JsonAllocator* allocator, char const* str, char const* at, const char* error, char const*& error_message)
+        {
+            char*    errmsg = allocator->AllocateArray<char>(256);
+            runes_t  msg    = ascii::make_runes(errmsg, errmsg + 256 - 1);
+            crunes_t fmt    = ascii::make_crunes("column %d: %s");
+            ncore::sprintf(msg, fmt, va_t((s32)(at - str) + 1), va_t(error));
+            error_message = errmsg;
+            return nullptr;
+        }
+
+        // "0" or a number without leading zeros that fits in a s32, anything else can only be an object member name
+        static s32 JsonPointerIndex(char const* key, s32 len)
+        {
+            if (len == 0 || len > 10 || (len > 1 && key[0] == '0'))
+                return -1;
+            s64 index = 0;
+            for (s32 i = 0; i < len; ++i)
+            {
+                if (key[i] < '0' || key[i] > '9')
+                    return -1;
+                index = index * 10 + (key[i] - '0');
+            }
+            return index <= 0x7FFFFFFF ? (s32)index : -1;
+        }
+
+        const JsonPointer* CompilePointer(char const* str, JsonAllocator* allocator, char const*& error_message) { return CompilePointer(str, str + ascii::strlen(str), allocator, error_message); }
+
+        const JsonPointer* CompilePointer(char const* str, char const* end, JsonAllocator* allocator, char const*& error_message)
+        {
+            error_message = nullptr;
+            if (str < end && *str != '/')
+                return JsonPointerError(allocator, str, str, "a pointer starts with '/'", error_message);
+
+            s32 count = 0;
+            for (char const* p = str; p < end; ++p)
+                count += *p == '/' ? 1 : 0;
+
+            // The keys are never longer than their escaped form, one block holds all of them
+            JsonPointer*     pointer = allocator->Allocate<JsonPointer>();
+            JsonPointerStep* steps   = allocator->AllocateArray<JsonPointerStep>(count);
+            char*            keys    = allocator->AllocateArray<char>((s32)(end - str) + 1);
+            pointer->m_Steps         = steps;
+            pointer->m_Count         = count;
+
+            char const* p = str;
+            for (s32 i = 0; i < count; ++i)
+            {
+                p += 1;
+                char* key = keys;
+                while (p < end && *p != '/')
+                {
+                    if (*p == '~')
+                    {
+                        char const e = (p + 1) < end ? p[1] : '\0';
+                        if (e != '0' && e != '1')
+                            return JsonPointerError(allocator, str, p, "'~' must be followed by '0' or '1'", error_message);
+                        *keys++ = e == '0' ? '~' : '/';
+                        p += 2;
+                    }
+                    else
+                    {
+                        *keys++ = *p++;
+                    }
+                }
+                *keys++ = '\0';
+
+                JsonPointerStep* step = &steps[i];
+                step->m_Key           = key;
+                step->m_KeyLen        = (s32)(keys - key) - 1;
+                step->m_Hash          = JsonHashName(key, key + step->m_KeyLen);
+                step->m_Index         = JsonPointerIndex(key, step->m_KeyLen);
+            }
+            return pointer;
+        }
+
+        const JsonValue* Resolve(JsonPointer const* pointer, JsonValue const* root)
+        {
+            JsonValue const* value = root;
+            for (s32 i = 0; i < pointer->m_Count && value != nullptr; ++i)
+            {
+                JsonPointerStep const* step = &pointer->m_Steps[i];
+                if (value->IsObject())
+                    value = value->Find(step->m_Key, step->m_KeyLen, step->m_Hash);
+                else if (value->IsArray() && step->m_Index >= 0)
+                    value = value->At(step->m_Index);
+                else
+                    return nullptr;
+            }
+            return value;
+        }
+
+        const nscanner::JsonValue* Resolve(JsonPointer const* pointer, nscanner::JsonValue const* root)
+        {
+            nscanner::JsonValue const* value = root;
+            for (s32 i = 0; i < pointer->m_Count && value != nullptr; ++i)
+            {
+                JsonPointerStep const* step = &pointer->m_Steps[i];
+                if (value->IsObject())
+                {
+                    value = value->Find(step->m_Key, step->m_KeyLen);
+                }
+                else if (value->IsArray() && step->m_Index >= 0)
+                {
+                    i32                              count   = 0;
+                    nscanner::JsonLinkedValue const* element = value->ArrayHead(count);
+                    if (step->m_Index >= count)
+                        return nullptr;
+                    for (s32 j = 0; j < step->m_Index; ++j)
+                        element = element->m_Next;
+                    value = element->m_Value;
+                }
+                else
+                {
+                    return nullptr;
+                }
+            }
+            return value;
+        }
+
+        JsonTapeValue Resolve(JsonPointer const* pointer, JsonTapeValue root)
+        {
+            JsonTapeValue value = root;
+            for (s32 i = 0; i < pointer->m_Count && value.IsValid(); ++i)
+            {
+                JsonPointerStep const* step = &pointer->m_Steps[i];
+                if (value.IsObject())
+                {
+                    value = value.Find(step->m_Key, step->m_KeyLen);
+                }
+                else if (value.IsArray() && step->m_Index >= 0)
+                {
+                    value = value.At(step->m_Index);
+                }
+                else
+                {
+                    value.m_Tape  = nullptr;
+                    value.m_Index = 0;
+                }
+            }
+            return value;
+        }
+
+    } // namespace njson
+} // namespace ncore
@@ -6,7 +6,7 @@
 #include "cjson/c_json_utils.h"
 #include "cjson/c_json_allocator.h"
 #include "cjson/c_json_scanner.h"
-#include "cjson/c_json_scanner_lexer.h"
+#include "cjson/c_json_lexer.h"
 
 namespace ncore
 {
@@ -14,251 +14,411 @@ namespace ncore
     {
         namespace nscanner
         {
+            // Strings, numbers and literals are not converted, they are the text in the input
+            typedef JsonLexerPolicy<JsonStringSpan, JsonNumberRaw, JsonUtf8Trust> JsonScanLexer;
+
+            const JsonValue* JsonValue::Find(const char* key) const { return Find(key, ascii::strlen(key)); }
+
+            // Members are linked in reverse document order, the first match is the member that came last
+            const JsonValue* JsonValue::Find(const char* key, s32 len) const
+            {
+                const JsonObjectValue* obj = AsObject();
+                if (obj->m_Count == kJsonLazyCount)
+                    Expand();
+                if (obj->m_Count == kJsonErrorCount)
+                    return nullptr;
+                for (const JsonLinkedNamedValue* member = obj->m_LinkedList; member != nullptr; member = member->m_Next)
+                {
+                    const JsonStringValue* name = member->m_NamedValue->m_Name;
+                    if ((name->m_End - name->m_String) == len && nmem::memcmp(name->m_String, key, len) == 0)
+                        return member->m_NamedValue->m_Value;
+                }
+                return nullptr;
+            }
+
+            // An array or object that is being scanned, frames are kept when popped and
+            // reused, memory is only allocated when the document reaches a new depth.
+            struct JsonScanFrame
+            {
+                JsonScanFrame*   m_Parent;
+                JsonScanFrame*   m_Child;
+                JsonValue*       m_Container;
+                JsonLinkedValue* m_Tail;    // array, last element
+                const char*      m_Name;    // object, name of the member whose value is being scanned
+                const char*      m_NameEnd; // object
+                bool             m_SeenValue;
+                bool             m_SeenComma;
+            };
+
             struct JsonState
             {
-                JsonLexerState m_Lexer;
-                char*          m_ErrorMessage;
-                JsonAllocator* m_Allocator;
-                int            m_NumberOfObjects;
-                int            m_NumberOfNumbers;
-                int            m_NumberOfStrings;
-                int            m_NumberOfArrays;
-                int            m_NumberOfBooleans;
-                JsonValue*     m_NullValue;
+                JsonLexerState    m_Lexer;
+                JsonScanFrame*    m_Top;
+                JsonScanFrame*    m_Frames; // the frame of depth 1, deeper frames are chained
+                s32               m_Depth;
+                s32               m_MaxDepth;
+                s32               m_LazyDepth; // arrays and objects at this depth or deeper are skipped and recorded as a span
+                char*             m_ErrorMessage;
+                JsonAllocator*    m_Allocator;
+                JsonLazyDocument* m_Document; // allocated with the first lazy container
+                int               m_NumberOfObjects;
+                int               m_NumberOfNumbers;
+                int               m_NumberOfStrings;
+                int               m_NumberOfArrays;
+                int               m_NumberOfBooleans;
+                const JsonValue*  m_NullValue;
             };
 
-            static void JsonStateInit(JsonState* state, JsonAllocator* alloc, char const* buffer, char const* end)
+            // 'document' is the document of the container that is expanded, nullptr when a document is scanned
+            static void JsonStateInit(JsonState* state, JsonAllocator* alloc, JsonLazyDocument const* document, char const* buffer, char const* end, s32 max_depth, s32 lazy_depth)
             {
-                JsonLexerStateInit(&state->m_Lexer, buffer, end, alloc);
-                state->m_ErrorMessage      = nullptr;
-                state->m_Allocator         = alloc;
-                state->m_NumberOfObjects   = 0;
-                state->m_NumberOfNumbers   = 0;
-                state->m_NumberOfStrings   = 0;
-                state->m_NumberOfArrays    = 0;
-                state->m_NumberOfBooleans  = 2;
-                state->m_NullValue         = alloc->Allocate<JsonValue>();
-                state->m_NullValue->m_Type = JsonValue::kNull;
+                JsonLexerStateInit(&state->m_Lexer, buffer, end, alloc, alloc);
+                state->m_Top              = nullptr;
+                state->m_Frames           = nullptr;
+                state->m_Depth            = 0;
+                state->m_MaxDepth         = max_depth;
+                state->m_LazyDepth        = lazy_depth;
+                state->m_ErrorMessage     = nullptr;
+                state->m_Allocator        = alloc;
+                state->m_Document         = const_cast<JsonLazyDocument*>(document);
+                state->m_NumberOfObjects  = 0;
+                state->m_NumberOfNumbers  = 0;
+                state->m_NumberOfStrings  = 0;
+                state->m_NumberOfArrays   = 0;
+                state->m_NumberOfBooleans = 2;
+                if (document != nullptr)
+                {
+                    state->m_Lexer.m_Text = document->m_Text;
+                    state->m_NullValue    = document->m_NullValue;
+                }
+                else
+                {
+                    JsonValue* null_value = alloc->Allocate<JsonValue>();
+                    null_value->m_Type    = JsonValue::kNull;
+                    state->m_NullValue    = null_value;
+                }
             }
 
             static JsonValue* JsonError(JsonState* state, const char* error)
             {
                 state->m_ErrorMessage = state->m_Allocator->AllocateArray<char>(1024);
                 runes_t  errmsg       = ascii::make_runes(state->m_ErrorMessage, state->m_ErrorMessage + 1024 - 1);
-                crunes_t fmt          = ascii::make_crunes("line %d: %s");
-                ncore::sprintf(errmsg, fmt, va_t(state->m_Lexer.m_LineNumber), va_t(error));
+                crunes_t fmt          = ascii::make_crunes("line %d, column %d: %s");
+                s32      line, column;
+                JsonLexerPosition(&state->m_Lexer, line, column);
+                ncore::sprintf(errmsg, fmt, va_t(line), va_t(column), va_t(error));
                 return nullptr;
             }
 
-            static const JsonValue* JsonParseValue(JsonState* json_state);
-
-            static const JsonValue* JsonParseObject(JsonState* json_state)
+            enum EJsonScanStep
             {
-                JsonLexerState* lexer = &json_state->m_Lexer;
-
-                if (!JsonLexerExpect(lexer, kJsonLexBeginObject))
-                    return JsonError(json_state, "missing '{'");
-
-                bool seen_value = false;
-                bool seen_comma = false;
-
-                JsonAllocator* alloc  = json_state->m_Allocator;
-                JsonValue*     result = alloc->Allocate<JsonValue>();
-                result->m_Type        = JsonValue::kObject;
-
-                result->m_Value.m_Object.m_Count      = 0;
-                result->m_Value.m_Object.m_LinkedList = nullptr;
+                kJsonScanStepValue, // the container expects a value
+                kJsonScanStepDone,  // the container is closed
+                kJsonScanStepError,
+            };
 
-                bool done = false;
-                while (!done)
+            static const JsonValue* JsonScanScalar(JsonState* json_state, JsonLexeme const& l)
+            {
+                const JsonValue* result = nullptr;
+                switch (l.m_Type)
                 {
-                    JsonLexeme l = JsonLexerNext(lexer);
+                    case kJsonLexString:
+                    {
+                        json_state->m_NumberOfStrings += 1;
+                        JsonValue* sv                 = json_state->m_Allocator->Allocate<JsonValue>();
+                        sv->m_Type                    = JsonValue::kString;
+                        sv->m_Value.m_String.m_String = l.m_String.m_Str;
+                        sv->m_Value.m_String.m_End    = l.m_String.m_Str + l.m_String.m_Len;
+                        result                        = sv;
+                        break;
+                    }
 
-                    switch (l.m_Type)
+                    case kJsonLexNumber:
                     {
-                        case kJsonLexString:
-                        {
-                            if (seen_value && !seen_comma)
-                                return JsonError(json_state, "missing ','");
+                        json_state->m_NumberOfNumbers += 1;
+                        JsonValue* nv                 = json_state->m_Allocator->Allocate<JsonValue>();
+                        nv->m_Type                    = JsonValue::kNumber;
+                        nv->m_Value.m_Number.m_String = l.m_String.m_Str;
+                        nv->m_Value.m_Number.m_End    = l.m_String.m_Str + l.m_String.m_Len;
+                        result                        = nv;
+                        break;
+                    }
 
-                            if (!JsonLexerExpect(lexer, kJsonLexNameSeparator))
-                                return JsonError(json_state, "missing ':'");
+                    case kJsonLexBoolean:
+                    {
+                        JsonValue* nv                 = json_state->m_Allocator->Allocate<JsonValue>();
+                        nv->m_Type                    = JsonValue::kBoolean;
+                        nv->m_Value.m_Number.m_String = l.m_String.m_Str;
+                        nv->m_Value.m_Number.m_End    = l.m_String.m_Str + l.m_String.m_Len;
+                        result                        = nv;
+                        break;
+                    }
 
-                            const JsonValue* value = JsonParseValue(json_state);
+                    case kJsonLexNull: result = json_state->m_NullValue; break;
 
-                            if (value == nullptr)
-                                return nullptr;
+                    default: return JsonError(json_state, "invalid document");
+                }
 
-                            JsonNamedValue*  named_value = alloc->Allocate<JsonNamedValue>();
-                            JsonStringValue* name        = alloc->Allocate<JsonStringValue>();
-                            name->m_String               = l.m_Str;
-                            name->m_End                  = l.m_Str + l.m_Len;
-                            named_value->m_Name          = name;
-                            named_value->m_Value         = value;
+                JsonLexerSkip<JsonScanLexer>(&json_state->m_Lexer);
+                return result;
+            }
 
-                            JsonLinkedNamedValue* linked_value = alloc->Allocate<JsonLinkedNamedValue>();
-                            linked_value->m_NamedValue         = named_value;
-                            linked_value->m_Next               = result->m_Value.m_Object.m_LinkedList;
+            // Skip an array or object, the value only records its text and is expanded when it is accessed
+            static const JsonValue* JsonScanLazy(JsonState* json_state, JsonValue::Type type)
+            {
+                JsonLexerState* lexer = &json_state->m_Lexer;
+                JsonLexerSkip<JsonScanLexer>(lexer);
 
-                            result->m_Value.m_Object.m_LinkedList = linked_value;
-                            result->m_Value.m_Object.m_Count += 1;
+                char const* begin = lexer->m_Cursor - 1;
+                char const* end   = JsonLexerSkipContainer(lexer);
+                if (end == nullptr)
+                    return JsonError(json_state, "end of file inside array or object");
 
-                            seen_value = true;
-                            seen_comma = false;
-                        }
-                        break;
+                JsonLazyDocument* document = json_state->m_Document;
+                if (document == nullptr)
+                {
+                    document               = json_state->m_Allocator->Allocate<JsonLazyDocument>();
+                    document->m_Text       = lexer->m_Text;
+                    document->m_Allocator  = json_state->m_Allocator;
+                    document->m_NullValue  = json_state->m_NullValue;
+                    json_state->m_Document = document;
+                }
 
-                        case kJsonLexEndObject: done = true; break;
+                JsonLazySpan* span = json_state->m_Allocator->Allocate<JsonLazySpan>();
+                span->m_Begin      = begin;
+                span->m_End        = end;
+                span->m_Document   = document;
 
-                        case kJsonLexValueSeparator:
-                        {
-                            if (!seen_value)
-                                return JsonError(json_state, "expected key name");
+                JsonValue* lv              = json_state->m_Allocator->Allocate<JsonValue>();
+                lv->m_Type                 = type;
+                lv->m_Value.m_Lazy.m_Count = kJsonLazyCount;
+                lv->m_Value.m_Lazy.m_Span  = span;
+                return lv;
+            }
 
-                            if (seen_comma)
-                                return JsonError(json_state, "duplicate comma");
+            static bool JsonScanPush(JsonState* json_state, JsonValue::Type type)
+            {
+                if (json_state->m_Depth == json_state->m_MaxDepth)
+                    return false;
 
-                            seen_value = false;
-                            seen_comma = true;
-                            break;
-                        }
+                JsonValue* container = json_state->m_Allocator->Allocate<JsonValue>();
+                container->m_Type    = type;
+                if (type == JsonValue::kObject)
+                {
+                    container->m_Value.m_Object.m_Count      = 0;
+                    container->m_Value.m_Object.m_LinkedList = nullptr;
+                }
+                else
+                {
+                    container->m_Value.m_Array.m_Count      = 0;
+                    container->m_Value.m_Array.m_LinkedList = nullptr;
+                }
 
-                        default: return JsonError(json_state, "expected object to continue");
-                    }
+                // Frames are chained by depth, the frame of a depth that was reached before is reused
+                JsonScanFrame* top   = json_state->m_Top;
+                JsonScanFrame* frame = top != nullptr ? top->m_Child : json_state->m_Frames;
+                if (frame == nullptr)
+                {
+                    frame           = json_state->m_Allocator->Allocate<JsonScanFrame>();
+                    frame->m_Parent = top;
+                    frame->m_Child  = nullptr;
+                    if (top != nullptr)
+                        top->m_Child = frame;
+                    else
+                        json_state->m_Frames = frame;
                 }
 
-                json_state->m_NumberOfObjects += 1;
-                return result;
+                frame->m_Container = container;
+                frame->m_Tail      = nullptr;
+                frame->m_Name      = nullptr;
+                frame->m_NameEnd   = nullptr;
+                frame->m_SeenValue = false;
+                frame->m_SeenComma = false;
+                json_state->m_Top  = frame;
+                json_state->m_Depth += 1;
+                return true;
             }
 
-            static const JsonValue* JsonParseArray(JsonState* json_state)
+            static void JsonScanPop(JsonState* json_state)
             {
-                JsonLexerState* lexer = &json_state->m_Lexer;
-
-                if (!JsonLexerExpect(lexer, kJsonLexBeginArray))
-                    return JsonError(json_state, "expected '['");
+                json_state->m_Top = json_state->m_Top->m_Parent;
+                json_state->m_Depth -= 1;
+            }
 
-                JsonAllocator* alloc = json_state->m_Allocator;
+            // Add 'value' (if any) as the member that was named before and read up to the next member value or the end of the object
+            static EJsonScanStep JsonScanObjectStep(JsonState* json_state, JsonScanFrame* frame, const JsonValue* value)
+            {
+                JsonLexerState* lexer  = &json_state->m_Lexer;
+                JsonAllocator*  alloc  = json_state->m_Allocator;
+                JsonValue*      result = frame->m_Container;
 
-                JsonValue* result                    = alloc->Allocate<JsonValue>();
-                result->m_Type                       = JsonValue::kArray;
-                result->m_Value.m_Array.m_Count      = 0;
-                result->m_Value.m_Array.m_LinkedList = nullptr;
+                if (value != nullptr)
+                {
+                    JsonNamedValue*  named_value = alloc->Allocate<JsonNamedValue>();
+                    JsonStringValue* name        = alloc->Allocate<JsonStringValue>();
+                    name->m_String               = frame->m_Name;
+                    name->m_End                  = frame->m_NameEnd;
+                    named_value->m_Name          = name;
+                    named_value->m_Value         = value;
+
+                    JsonLinkedNamedValue* linked_value = alloc->Allocate<JsonLinkedNamedValue>();
+                    linked_value->m_NamedValue         = named_value;
+                    linked_value->m_Next               = result->m_Value.m_Object.m_LinkedList;
+
+                    result->m_Value.m_Object.m_LinkedList = linked_value;
+                    result->m_Value.m_Object.m_Count += 1;
+
+                    frame->m_SeenValue = true;
+                    frame->m_SeenComma = false;
+                }
 
-                i32              count = 0;
-                JsonLinkedValue* head  = nullptr;
-                JsonLinkedValue* tail  = nullptr;
                 for (;;)
                 {
-                    JsonLexeme l = JsonLexerPeek(lexer);
+                    JsonLexeme l = JsonLexerNext<JsonScanLexer>(lexer);
 
-                    if (kJsonLexEndArray == l.m_Type)
+                    switch (l.m_Type)
                     {
-                        JsonLexerSkip(lexer);
-                        break;
-                    }
+                        case kJsonLexString:
+                        {
+                            if (frame->m_SeenValue && !frame->m_SeenComma)
+                            {
+                                JsonError(json_state, "missing ','");
+                                return kJsonScanStepError;
+                            }
+
+                            if (!JsonLexerExpect<JsonScanLexer>(lexer, kJsonLexNameSeparator))
+                            {
+                                JsonError(json_state, "missing ':'");
+                                return kJsonScanStepError;
+                            }
+
+                            frame->m_Name    = l.m_String.m_Str;
+                            frame->m_NameEnd = l.m_String.m_Str + l.m_String.m_Len;
+                            return kJsonScanStepValue;
+                        }
 
-                    if (count > 0)
-                    {
-                        if (kJsonLexValueSeparator != l.m_Type)
+                        case kJsonLexEndObject: json_state->m_NumberOfObjects += 1; return kJsonScanStepDone;
+
+                        case kJsonLexValueSeparator:
                         {
-                            return JsonError(json_state, "expected ','");
+                            if (!frame->m_SeenValue)
+                            {
+                                JsonError(json_state, "expected key name");
+                                return kJsonScanStepError;
+                            }
+
+                            if (frame->m_SeenComma)
+                            {
+                                JsonError(json_state, "duplicate comma");
+                                return kJsonScanStepError;
+                            }
+
+                            frame->m_SeenValue = false;
+                            frame->m_SeenComma = true;
+                            break;
                         }
 
-                        JsonLexerSkip(lexer);
+                        default: JsonError(json_state, "expected object to continue"); return kJsonScanStepError;
                     }
+                }
+            }
 
-                    const JsonValue* value = JsonParseValue(json_state);
-                    if (!value)
-                        return nullptr;
+            // Append 'value' (if any) and read up to the next element or the end of the array
+            static EJsonScanStep JsonScanArrayStep(JsonState* json_state, JsonScanFrame* frame, const JsonValue* value)
+            {
+                JsonLexerState* lexer  = &json_state->m_Lexer;
+                JsonValue*      result = frame->m_Container;
 
-                    JsonLinkedValue* linked_value = alloc->Allocate<JsonLinkedValue>();
+                if (value != nullptr)
+                {
+                    JsonLinkedValue* linked_value = json_state->m_Allocator->Allocate<JsonLinkedValue>();
                     linked_value->m_Value         = value;
                     linked_value->m_Next          = nullptr;
-                    if (count == 0)
-                    {
-                        head = tail = linked_value;
-                    }
+                    if (frame->m_Tail == nullptr)
+                        result->m_Value.m_Array.m_LinkedList = linked_value;
                     else
-                    {
-                        tail->m_Next = linked_value;
-                        tail         = linked_value;
-                    }
-                    count += 1;
+                        frame->m_Tail->m_Next = linked_value;
+                    frame->m_Tail = linked_value;
+                    result->m_Value.m_Array.m_Count += 1;
                 }
 
-                result->m_Value.m_Array.m_Count      = count;
-                result->m_Value.m_Array.m_LinkedList = head;
+                JsonLexeme l = JsonLexerPeek<JsonScanLexer>(lexer);
 
-                json_state->m_NumberOfArrays += 1;
+                if (kJsonLexEndArray == l.m_Type)
+                {
+                    JsonLexerSkip<JsonScanLexer>(lexer);
+                    json_state->m_NumberOfArrays += 1;
+                    return kJsonScanStepDone;
+                }
 
-                return result;
+                if (result->m_Value.m_Array.m_Count > 0)
+                {
+                    if (kJsonLexValueSeparator != l.m_Type)
+                    {
+                        JsonError(json_state, "expected ','");
+                        return kJsonScanStepError;
+                    }
+
+                    JsonLexerSkip<JsonScanLexer>(lexer);
+                }
+
+                return kJsonScanStepValue;
             }
 
+            // Iterative, nested arrays and objects are frames on an explicit stack instead of recursive calls
             static const JsonValue* JsonParseValue(JsonState* json_state)
             {
-                const JsonValue* result = nullptr;
-                JsonLexeme       l      = JsonLexerPeek(&json_state->m_Lexer);
-                switch (l.m_Type)
+                JsonLexerState* lexer = &json_state->m_Lexer;
+                for (;;)
                 {
-                    case kJsonLexBeginObject: result = JsonParseObject(json_state); break;
-                    case kJsonLexBeginArray: result = JsonParseArray(json_state); break;
-
-                    case kJsonLexString:
+                    // A value, either a scalar or the start of an array or object
+                    const JsonValue* value = nullptr;
+                    JsonLexeme       l     = JsonLexerPeek<JsonScanLexer>(lexer);
+                    if ((kJsonLexBeginObject == l.m_Type || kJsonLexBeginArray == l.m_Type) && json_state->m_Depth >= json_state->m_LazyDepth)
                     {
-                        json_state->m_NumberOfStrings += 1;
-                        JsonValue* sv                 = json_state->m_Allocator->Allocate<JsonValue>();
-                        sv->m_Type                    = JsonValue::kString;
-                        sv->m_Value.m_String.m_String = l.m_Str;
-                        sv->m_Value.m_String.m_End    = l.m_Str + l.m_Len;
-                        result                        = sv;
-                        JsonLexerSkip(&json_state->m_Lexer);
-                        break;
+                        value = JsonScanLazy(json_state, kJsonLexBeginObject == l.m_Type ? JsonValue::kObject : JsonValue::kArray);
+                        if (value == nullptr)
+                            return nullptr;
                     }
-
-                    case kJsonLexNumber:
+                    else if (kJsonLexBeginObject == l.m_Type || kJsonLexBeginArray == l.m_Type)
                     {
-                        json_state->m_NumberOfNumbers += 1;
-                        JsonValue* nv                 = json_state->m_Allocator->Allocate<JsonValue>();
-                        nv->m_Type                    = JsonValue::kNumber;
-                        nv->m_Value.m_Number.m_String = l.m_Str;
-                        nv->m_Value.m_Number.m_End    = l.m_Str + l.m_Len;
-                        result                        = nv;
-                        JsonLexerSkip(&json_state->m_Lexer);
+                        if (!JsonScanPush(json_state, kJsonLexBeginObject == l.m_Type ? JsonValue::kObject : JsonValue::kArray))
+                            return JsonError(json_state, "maximum nesting depth exceeded");
+                        JsonLexerSkip<JsonScanLexer>(lexer);
                     }
-                    break;
-
-                    case kJsonLexBoolean:
+                    else
                     {
-                        JsonValue* nv                 = json_state->m_Allocator->Allocate<JsonValue>();
-                        nv->m_Type                    = JsonValue::kBoolean;
-                        nv->m_Value.m_Number.m_String = l.m_Str;
-                        nv->m_Value.m_Number.m_End    = l.m_Str + l.m_Len;
-                        result                        = nv;
-                        JsonLexerSkip(&json_state->m_Lexer);
+                        value = JsonScanScalar(json_state, l);
+                        if (value == nullptr)
+                            return nullptr;
                     }
-                    break;
 
-                    case kJsonLexNull:
+                    // Add the value to its container, closing containers until one expects another value
+                    while (json_state->m_Top != nullptr)
                     {
-                        result = json_state->m_NullValue;
-                        JsonLexerSkip(&json_state->m_Lexer);
+                        JsonScanFrame* frame = json_state->m_Top;
+                        EJsonScanStep  step  = frame->m_Container->m_Type == JsonValue::kObject ? JsonScanObjectStep(json_state, frame, value) : JsonScanArrayStep(json_state, frame, value);
+                        if (step == kJsonScanStepError)
+                            return nullptr;
+                        if (step == kJsonScanStepValue)
+                            break;
+
+                        value = frame->m_Container;
+                        JsonScanPop(json_state);
                     }
-                    break;
 
-                    default: result = JsonError(json_state, "invalid document"); break;
+                    if (json_state->m_Top == nullptr)
+                        return value;
                 }
-
-                return result;
             }
 
-            const JsonValue* Scan(char const* str, char const* end, JsonAllocator* allocator, char const*& error_message)
+            static const JsonValue* JsonScanDocument(char const* str, char const* end, JsonAllocator* allocator, JsonLazyDocument const* document, s32 max_depth, s32 lazy_depth, char const*& error_message)
             {
                 JsonState json_state;
-                JsonStateInit(&json_state, allocator, str, end);
+                JsonStateInit(&json_state, allocator, document, str, end, max_depth, lazy_depth);
 
                 const JsonValue* root = JsonParseValue(&json_state);
-                if (root && !JsonLexerExpect(&json_state.m_Lexer, kJsonLexEof))
+                if (root && !JsonLexerExpect<JsonScanLexer>(&json_state.m_Lexer, kJsonLexEof))
                 {
                     root = JsonError(&json_state, "data after document");
                 }
@@ -266,15 +426,48 @@ namespace ncore
                 error_message = nullptr;
                 if (!root)
                 {
-                    s32 const len    = ascii::strlen(json_state.m_ErrorMessage);
-                    char*     errmsg = allocator->AllocateArray<char>(len + 1);
-                    nmem::memcpy(errmsg, json_state.m_ErrorMessage, len);
+                    char const* msg    = json_state.m_ErrorMessage != nullptr ? json_state.m_ErrorMessage : json_state.m_Lexer.m_ErrorMessage;
+                    s32 const   len    = ascii::strlen(msg);
+                    char*       errmsg = allocator->AllocateArray<char>(len + 1);
+                    nmem::memcpy(errmsg, msg, len);
                     errmsg[len]   = '\0';
                     error_message = errmsg;
                 }
 
                 return root;
             }
+
+            const JsonValue* Scan(char const* str, char const* end, JsonAllocator* allocator, char const*& error_message) { return Scan(str, end, allocator, kJsonDefaultMaxDepth, error_message); }
+
+            const JsonValue* Scan(char const* str, char const* end, JsonAllocator* allocator, s32 max_depth, char const*& error_message) { return JsonScanDocument(str, end, allocator, nullptr, max_depth, 0x7FFFFFFF, error_message); }
+
+            const JsonValue* ScanLazy(char const* str, char const* end, JsonAllocator* allocator, char const*& error_message) { return JsonScanDocument(str, end, allocator, nullptr, kJsonDefaultMaxDepth, 0, error_message); }
+
+            // The container is scanned on its own, its children that are arrays or objects are lazy again. It shares the
+            // literals of its document and reports an error at its position in the document.
+            const char* JsonValue::Expand() const
+            {
+                if (IsError())
+                    return m_Value.m_Error.m_ErrorMessage;
+                if (!IsLazy())
+                    return nullptr;
+
+                JsonLazySpan const* span   = m_Value.m_Lazy.m_Span;
+                const char*         errmsg = nullptr;
+                const JsonValue*    value  = JsonScanDocument(span->m_Begin, span->m_End, span->m_Document->m_Allocator, span->m_Document, kJsonDefaultMaxDepth, 1, errmsg);
+
+                JsonValue* self = const_cast<JsonValue*>(this);
+                if (value != nullptr)
+                {
+                    self->m_Value = value->m_Value;
+                }
+                else
+                {
+                    self->m_Value.m_Error.m_Count        = kJsonErrorCount;
+                    self->m_Value.m_Error.m_ErrorMessage = errmsg;
+                }
+                return errmsg;
+            }
         } // namespace nscanner
 
     } // namespace njson
@@ -0,0 +1,97 @@
+#include "cbase/c_allocator.h"
+#include "cbase/c_memory.h"
+#include "cjson/c_json_string_pool.h"
+#include "cjson/c_json_utils.h"
+
+namespace ncore
+{
+    namespace njson
+    {
+        void JsonStringPool::Init(alloc_t* alloc, s32 max_strings, s64 max_bytes, const char* debug_name)
+        {
+            // Offsets are 32-bit
+            ASSERT(max_bytes <= (s64)0xFFFFFFFF);
+
+            u32 slots = 16;
+            while (slots < (u32)(2 * max_strings))
+                slots <<= 1;
+
+            this->m_Alloc    = alloc;
+            this->m_Slots    = g_allocate_array<u64>(alloc, slots);
+            this->m_Mask     = slots - 1;
+            this->m_Count    = 0;
+            this->m_MaxCount = max_strings;
+            this->m_Strings.Init(alloc, max_bytes, debug_name);
+            Reset();
+        }
+
+        void JsonStringPool::Destroy()
+        {
+            if (this->m_Alloc != nullptr)
+            {
+                g_deallocate_array(this->m_Alloc, this->m_Slots);
+                this->m_Alloc = nullptr;
+            }
+            this->m_Strings.Destroy();
+            this->m_Slots    = nullptr;
+            this->m_Mask     = 0;
+            this->m_Count    = 0;
+            this->m_MaxCount = 0;
+        }
+
+        void JsonStringPool::Reset()
+        {
+            nmem::memset(this->m_Slots, 0, sizeof(u64) * (this->m_Mask + 1));
+            this->m_Strings.Reset();
+            this->m_Count = 0;
+        }
+
+        const char* JsonStringPool::Intern(const char* str, const char* end) { return Intern(str, end, JsonHashName(str, end)); }
+
+        const char* JsonStringPool::Intern(const char* str, const char* end, u32 hash)
+        {
+            s64 const len  = end - str;
+            u32       slot = hash & this->m_Mask;
+            for (; this->m_Slots[slot] != 0; slot = (slot + 1) & this->m_Mask)
+            {
+                u64 const entry = this->m_Slots[slot];
+                if ((u32)(entry >> 32) != hash)
+                    continue;
+                const char* pooled = this->m_Strings.m_Pointer + (u32)entry;
+                if (Length(pooled) == len && nmem::memcmp(pooled, str, len) == 0)
+                    return pooled;
+            }
+
+            if (this->m_Count == this->m_MaxCount || (this->m_Strings.m_Capacity - this->m_Strings.m_Size) < (s64)(sizeof(u32) + len + 1 + sizeof(void*)))
+                return nullptr;
+
+            // Offsets are never 0, the length is in front of the string
+            char* mem = this->m_Strings.Allocate(sizeof(u32) + len + 1, sizeof(u32));
+            *(u32*)mem = (u32)len;
+            char* pooled = mem + sizeof(u32);
+            nmem::memcpy(pooled, str, len);
+            pooled[len] = '\0';
+
+            this->m_Slots[slot] = ((u64)hash << 32) | (u64)(pooled - this->m_Strings.m_Pointer);
+            this->m_Count += 1;
+            return pooled;
+        }
+
+        const char* JsonStringPool::Find(const char* str, const char* end) const
+        {
+            s64 const len  = end - str;
+            u32 const hash = JsonHashName(str, end);
+            for (u32 slot = hash & this->m_Mask; this->m_Slots[slot] != 0; slot = (slot + 1) & this->m_Mask)
+            {
+                u64 const entry = this->m_Slots[slot];
+                if ((u32)(entry >> 32) != hash)
+                    continue;
+                const char* pooled = this->m_Strings.m_Pointer + (u32)entry;
+                if (Length(pooled) == len && nmem::memcmp(pooled, str, len) == 0)
+                    return pooled;
+            }
+            return nullptr;
+        }
+
+    } // namespace njson
+} // namespace ncore
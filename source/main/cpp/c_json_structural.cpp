@@ -0,0 +1,197 @@
+#include "ccore/c_target.h"
+#include "ccore/c_debug.h"
+#include "cbase/c_memory.h"
+#include "cjson/c_json_simd.h"
+#include "cjson/c_json_structural.h"
+
+namespace ncore
+{
+    namespace njson
+    {
+        void JsonClassifyBlockScalar(const char* block, JsonBlockClass& out_class)
+        {
+            u64 quote      = 0;
+            u64 backslash  = 0;
+            u64 op         = 0;
+            u64 whitespace = 0;
+            for (s32 i = 0; i < 64; ++i)
+            {
+                u64 const bit = (u64)1 << i;
+                switch (block[i])
+                {
+                    case '"': quote |= bit; break;
+                    case '\\': backslash |= bit; break;
+                    case '{':
+                    case '}':
+                    case '[':
+                    case ']':
+                    case ',':
+                    case ':': op |= bit; break;
+                    case ' ':
+                    case '\t':
+                    case '\n':
+                    case '\r': whitespace |= bit; break;
+                }
+            }
+            out_class.m_Quote      = quote;
+            out_class.m_Backslash  = backslash;
+            out_class.m_Operator   = op;
+            out_class.m_Whitespace = whitespace;
+        }
+
+#if defined(CJSON_SIMD_AVX2)
+        static inline u64 ClassifyMask32(__m256i v, __m256i c) { return (u64)(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, c)); }
+
+        void JsonClassifyBlock(const char* block, JsonBlockClass& out_class)
+        {
+            // '[' | 0x20 == '{' and ']' | 0x20 == '}', no other byte maps onto these two
+            __m256i const lower = _mm256_set1_epi8(0x20);
+            out_class.m_Quote      = 0;
+            out_class.m_Backslash  = 0;
+            out_class.m_Operator   = 0;
+            out_class.m_Whitespace = 0;
+            for (s32 i = 0; i < 64; i += 32)
+            {
+                __m256i const v  = _mm256_loadu_si256((__m256i const*)(block + i));
+                __m256i const vl = _mm256_or_si256(v, lower);
+
+                u64 const op = ClassifyMask32(vl, _mm256_set1_epi8('{')) | ClassifyMask32(vl, _mm256_set1_epi8('}')) | ClassifyMask32(v, _mm256_set1_epi8(',')) | ClassifyMask32(v, _mm256_set1_epi8(':'));
+                u64 const ws = ClassifyMask32(v, _mm256_set1_epi8(' ')) | ClassifyMask32(v, _mm256_set1_epi8('\t')) | ClassifyMask32(v, _mm256_set1_epi8('\n')) | ClassifyMask32(v, _mm256_set1_epi8('\r'));
+
+                out_class.m_Quote |= ClassifyMask32(v, _mm256_set1_epi8('"')) << i;
+                out_class.m_Backslash |= ClassifyMask32(v, _mm256_set1_epi8('\\')) << i;
+                out_class.m_Operator |= op << i;
+                out_class.m_Whitespace |= ws << i;
+            }
+        }
+#elif defined(CJSON_SIMD_SSE2)
+        static inline u64 ClassifyMask16(__m128i v, __m128i c) { return (u64)(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(v, c)); }
+
+        void JsonClassifyBlock(const char* block, JsonBlockClass& out_class)
+        {
+            // '[' | 0x20 == '{' and ']' | 0x20 == '}', no other byte maps onto these two
+            __m128i const lower = _mm_set1_epi8(0x20);
+            out_class.m_Quote      = 0;
+            out_class.m_Backslash  = 0;
+            out_class.m_Operator   = 0;
+            out_class.m_Whitespace = 0;
+            for (s32 i = 0; i < 64; i += 16)
+            {
+                __m128i const v  = _mm_loadu_si128((__m128i const*)(block + i));
+                __m128i const vl = _mm_or_si128(v, lower);
+
+                u64 const op = ClassifyMask16(vl, _mm_set1_epi8('{')) | ClassifyMask16(vl, _mm_set1_epi8('}')) | ClassifyMask16(v, _mm_set1_epi8(',')) | ClassifyMask16(v, _mm_set1_epi8(':'));
+                u64 const ws = ClassifyMask16(v, _mm_set1_epi8(' ')) | ClassifyMask16(v, _mm_set1_epi8('\t')) | ClassifyMask16(v, _mm_set1_epi8('\n')) | ClassifyMask16(v, _mm_set1_epi8('\r'));
+
+                out_class.m_Quote |= ClassifyMask16(v, _mm_set1_epi8('"')) << i;
+                out_class.m_Backslash |= ClassifyMask16(v, _mm_set1_epi8('\\')) << i;
+                out_class.m_Operator |= op << i;
+                out_class.m_Whitespace |= ws << i;
+            }
+        }
+#else
+        void JsonClassifyBlock(const char* block, JsonBlockClass& out_class) { JsonClassifyBlockScalar(block, out_class); }
+#endif
+
+        void JsonStructuralInit(JsonStructuralState* state, char const* str, char const* end)
+        {
+            state->m_Begin        = str;
+            state->m_Cursor       = str;
+            state->m_End          = end;
+            state->m_PrevEscaped  = 0;
+            state->m_PrevInString = 0;
+            state->m_PrevScalar   = 0;
+        }
+
+        // Return the mask of characters that are escaped by a backslash, a run of backslashes escapes
+        // every other character and the character following an odd length run.
+        static inline u64 JsonFindEscaped(JsonStructuralState* state, u64 backslash)
+        {
+            backslash &= ~state->m_PrevEscaped;
+            u64 const follows_escape = (backslash << 1) | state->m_PrevEscaped;
+
+            // Runs of backslashes that start on an odd bit, adding them to the backslash mask carries
+            // through the run and leaves a 1 after every odd length run.
+            u64 const even_bits           = 0x5555555555555555ull;
+            u64 const odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+            u64 const sequences_on_even   = odd_sequence_starts + backslash;
+            state->m_PrevEscaped          = (sequences_on_even < backslash) ? 1 : 0;
+
+            u64 const invert_mask = sequences_on_even << 1;
+            return (even_bits ^ invert_mask) & follows_escape;
+        }
+
+        static inline u64 JsonStructuralMask(JsonStructuralState* state, JsonBlockClass const& cls)
+        {
+            u64 const escaped   = JsonFindEscaped(state, cls.m_Backslash);
+            u64 const quote     = cls.m_Quote & ~escaped;
+            u64 const in_string = JsonPrefixXor64(quote) ^ state->m_PrevInString;
+
+            // 'in_string' covers the opening quote up to, but not including, the closing quote
+            state->m_PrevInString = (u64)((s64)in_string >> 63);
+
+            // A number or literal starts at a byte that is not whitespace, not an operator and that does not
+            // follow another such byte. A closing quote does not glue to what follows it.
+            u64 const scalar                  = ~(cls.m_Operator | cls.m_Whitespace);
+            u64 const nonquote_scalar         = scalar & ~quote;
+            u64 const follows_nonquote_scalar = (nonquote_scalar << 1) | state->m_PrevScalar;
+            state->m_PrevScalar               = nonquote_scalar >> 63;
+
+            u64 const scalar_start = scalar & ~follows_nonquote_scalar;
+            u64 const string_tail  = in_string ^ quote; // string content and closing quote
+            return (cls.m_Operator | scalar_start) & ~string_tail;
+        }
+
+        s32 JsonStructuralNextBlock(JsonStructuralState* state, u32* out_offsets)
+        {
+            if (state->m_Cursor >= state->m_End)
+                return 0;
+
+            const char* block     = state->m_Cursor;
+            s64 const   remaining = (s64)(state->m_End - state->m_Cursor);
+
+            char padded[64];
+            if (remaining < 64)
+            {
+                // Pad the tail with whitespace, which never produces a structural
+                nmem::memset(padded, ' ', sizeof(padded));
+                nmem::memcpy(padded, block, remaining);
+                block = padded;
+            }
+
+            JsonBlockClass cls;
+            JsonClassifyBlock(block, cls);
+            u64 structurals = JsonStructuralMask(state, cls);
+
+            u32 const base = (u32)(state->m_Cursor - state->m_Begin);
+            state->m_Cursor += (remaining < 64) ? remaining : 64;
+
+            s32 count = 0;
+            while (structurals != 0)
+            {
+                out_offsets[count++] = base + (u32)JsonCountTrailingZeros64(structurals);
+                structurals &= structurals - 1;
+            }
+            return count;
+        }
+
+        s32 JsonStructuralIndex(char const* str, char const* end, u32* out_offsets, s32 max_offsets)
+        {
+            JsonStructuralState state;
+            JsonStructuralInit(&state, str, end);
+
+            s32 count = 0;
+            u32 block_offsets[64];
+            while (!JsonStructuralDone(&state))
+            {
+                s32 const n = JsonStructuralNextBlock(&state, block_offsets);
+                if ((count + n) > max_offsets)
+                    return -1;
+                nmem::memcpy(out_offsets + count, block_offsets, n * sizeof(u32));
+                count += n;
+            }
+            return count;
+        }
+
+    } // namespace njson
+} // namespace ncore
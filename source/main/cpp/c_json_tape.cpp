@@ -0,0 +1,500 @@
+#include "cbase/c_allocator.h"
+#include "cbase/c_context.h"
+#include "cbase/c_memory.h"
+#include "cbase/c_printf.h"
+#include "cbase/c_runes.h"
+#include "cjson/c_json_utils.h"
+#include "cjson/c_json_allocator.h"
+#include "cjson/c_json_lexer.h"
+#include "cjson/c_json_tape.h"
+
+namespace ncore
+{
+    namespace njson
+    {
+        static inline u64 JsonTapeWord(u8 type, u64 payload) { return ((u64)type << 56) | (payload & 0x00FFFFFFFFFFFFFFull); }
+        static inline u64 JsonTapePayload(u64 word) { return word & 0x00FFFFFFFFFFFFFFull; }
+
+        static inline JsonTapeValue JsonTapeAt(JsonTape const* tape, s32 index)
+        {
+            JsonTapeValue v;
+            v.m_Tape  = tape;
+            v.m_Index = index;
+            return v;
+        }
+
+        bool JsonTapeValue::GetBoolean() const
+        {
+            ASSERT(IsBoolean());
+            return Type() == kJsonTapeTrue;
+        }
+
+        f64 JsonTapeValue::GetNumber() const
+        {
+            ASSERT(IsNumber());
+            u64 const bits = m_Tape->m_Words[m_Index + 1];
+            switch (Type())
+            {
+                case kJsonTapeInt64: return JsonNumberAsFloat64(JsonNumber(kJsonNumber_s64, (s64)bits));
+                case kJsonTapeUInt64: return JsonNumberAsFloat64(JsonNumber(kJsonNumber_u64, (s64)bits));
+                default: return JsonNumberAsFloat64(JsonNumber(kJsonNumber_f64, (s64)bits));
+            }
+        }
+
+        s64 JsonTapeValue::GetInt64() const
+        {
+            ASSERT(IsNumber());
+            u64 const bits = m_Tape->m_Words[m_Index + 1];
+            switch (Type())
+            {
+                case kJsonTapeInt64: return (s64)bits;
+                case kJsonTapeUInt64: return JsonNumberAsInt64(JsonNumber(kJsonNumber_u64, (s64)bits));
+                default: return JsonNumberAsInt64(JsonNumber(kJsonNumber_f64, (s64)bits));
+            }
+        }
+
+        u64 JsonTapeValue::GetUInt64() const
+        {
+            ASSERT(IsNumber());
+            u64 const bits = m_Tape->m_Words[m_Index + 1];
+            switch (Type())
+            {
+                case kJsonTapeUInt64: return bits;
+                case kJsonTapeInt64: return JsonNumberAsUInt64(JsonNumber(kJsonNumber_s64, (s64)bits));
+                default: return JsonNumberAsUInt64(JsonNumber(kJsonNumber_f64, (s64)bits));
+            }
+        }
+
+        const char* JsonTapeValue::GetString() const
+        {
+            ASSERT(IsString());
+            return m_Tape->m_Strings + JsonTapePayload(Word()) + sizeof(u32);
+        }
+
+        s32 JsonTapeValue::GetStringLength() const
+        {
+            ASSERT(IsString());
+            u32 len;
+            nmem::memcpy(&len, m_Tape->m_Strings + JsonTapePayload(Word()), sizeof(u32));
+            return (s32)len;
+        }
+
+        JsonTapeValue JsonTapeValue::Next() const
+        {
+            u64 const word = Word();
+            switch ((u8)(word >> 56))
+            {
+                case kJsonTapeObject:
+                case kJsonTapeArray: return JsonTapeAt(m_Tape, (s32)(u32)word + 1);
+                case kJsonTapeInt64:
+                case kJsonTapeUInt64:
+                case kJsonTapeFloat64: return JsonTapeAt(m_Tape, m_Index + 2);
+                default: return JsonTapeAt(m_Tape, m_Index + 1);
+            }
+        }
+
+        s32 JsonTapeValue::Count() const
+        {
+            ASSERT(IsObject() || IsArray());
+            s32 const count = (s32)((Word() >> 32) & kJsonTapeCountMax);
+            if (count < kJsonTapeCountMax)
+                return count;
+
+            // Saturated, count by walking the container
+            s32           n = 0;
+            JsonTapeValue v = First();
+            while (v.IsValid())
+            {
+                v = IsObject() ? v.Next().Next() : v.Next();
+                n += 1;
+            }
+            return n;
+        }
+
+        JsonTapeValue JsonTapeValue::First() const
+        {
+            ASSERT(IsObject() || IsArray());
+            return JsonTapeAt(m_Tape, m_Index + 1);
+        }
+
+        JsonTapeValue JsonTapeValue::At(s32 index) const
+        {
+            ASSERT(IsArray());
+            JsonTapeValue v = First();
+            for (s32 i = 0; i < index && v.IsValid(); ++i)
+                v = v.Next();
+            if (index < 0 || !v.IsValid())
+                return JsonTapeAt(nullptr, 0);
+            return v;
+        }
+
+        JsonTapeValue JsonTapeValue::Find(const char* key) const { return Find(key, ascii::strlen(key)); }
+
+        JsonTapeValue JsonTapeValue::Find(const char* key, s32 len) const
+        {
+            ASSERT(IsObject());
+
+            // Keep the last match, the same member that the other document types find
+            JsonTapeValue found = JsonTapeAt(nullptr, 0);
+            for (JsonTapeValue name = First(); name.IsValid(); name = name.Next().Next())
+            {
+                if (name.GetStringLength() == len && nmem::memcmp(name.GetString(), key, len) == 0)
+                    found = name.Next();
+            }
+            return found;
+        }
+
+        // ----------------------------------------------------------------------------------------------------------
+
+        // Strings are unescaped into the string buffer after their length, numbers and literals are converted
+        template <typename TUtf8> struct JsonTapeLexer
+        {
+            typedef JsonLexerPolicy<JsonStringPrefixed, JsonNumberConvert, TUtf8> Policy;
+        };
+
+        // An array or object that is being parsed, frames are kept when popped and
+        // reused, scratch memory is only allocated when the document reaches a new depth.
+        struct JsonTapeFrame
+        {
+            JsonTapeFrame* m_Parent;
+            JsonTapeFrame* m_Child;
+            s32            m_Start; // index of the start word
+            s32            m_Count; // members or elements
+            bool           m_IsObject;
+            bool           m_SeenValue;
+            bool           m_SeenComma;
+        };
+
+        struct JsonTapeState
+        {
+            JsonLexerState m_Lexer;
+            JsonTapeFrame* m_Top;
+            JsonTapeFrame* m_Frames; // the frame of depth 1, deeper frames are chained
+            s32            m_Depth;
+            s32            m_MaxDepth;
+            u64*           m_Words;
+            u64*           m_Cursor;
+            u64*           m_End;
+            char const*    m_Strings;
+            char*          m_ErrorMessage;
+            JsonAllocator* m_Scratch;
+        };
+
+        static bool JsonTapeError(JsonTapeState* state, const char* error)
+        {
+            state->m_ErrorMessage = state->m_Scratch->AllocateArray<char>(1024);
+            runes_t  errmsg       = ascii::make_runes(state->m_ErrorMessage, state->m_ErrorMessage + 1024 - 1);
+            crunes_t fmt          = ascii::make_crunes("line %d, column %d: %s");
+            s32      line, column;
+            JsonLexerPosition(&state->m_Lexer, line, column);
+            ncore::sprintf(errmsg, fmt, va_t(line), va_t(column), va_t(error));
+            return false;
+        }
+
+        static inline bool JsonTapeReserve(JsonTapeState* state, s32 words)
+        {
+            if ((state->m_End - state->m_Cursor) >= words)
+                return true;
+            return JsonTapeError(state, "out of memory while writing the tape");
+        }
+
+        static inline bool JsonTapeString(JsonTapeState* state, JsonLexeme const& l)
+        {
+            if (!JsonTapeReserve(state, 1))
+                return false;
+            u64 const offset   = (u64)((l.m_String.m_Str - sizeof(u32)) - state->m_Strings);
+            *state->m_Cursor++ = JsonTapeWord(kJsonTapeString, offset);
+            return true;
+        }
+
+        template <typename P> static bool JsonTapeScalar(JsonTapeState* state, JsonLexeme const& l)
+        {
+            switch (l.m_Type)
+            {
+                case kJsonLexString:
+                    if (!JsonTapeString(state, l))
+                        return false;
+                    break;
+
+                case kJsonLexNumber:
+                {
+                    if (!JsonTapeReserve(state, 2))
+                        return false;
+                    u8 const type      = l.m_Number.m_Type == kJsonNumber_s64 ? kJsonTapeInt64 : (l.m_Number.m_Type == kJsonNumber_u64 ? kJsonTapeUInt64 : kJsonTapeFloat64);
+                    *state->m_Cursor++ = JsonTapeWord(type, 0);
+                    *state->m_Cursor++ = l.m_Number.m_U64;
+                    break;
+                }
+
+                case kJsonLexBoolean:
+                case kJsonLexNull:
+                    if (!JsonTapeReserve(state, 1))
+                        return false;
+                    *state->m_Cursor++ = JsonTapeWord(l.m_Type == kJsonLexNull ? kJsonTapeNull : (l.m_Number.m_S64 != 0 ? kJsonTapeTrue : kJsonTapeFalse), 0);
+                    break;
+
+                default: return JsonTapeError(state, "invalid document");
+            }
+
+            JsonLexerSkip<P>(&state->m_Lexer);
+            return true;
+        }
+
+        static bool JsonTapePush(JsonTapeState* state, bool is_object)
+        {
+            if (state->m_Depth == state->m_MaxDepth)
+                return JsonTapeError(state, "maximum nesting depth exceeded");
+            if (!JsonTapeReserve(state, 1))
+                return false;
+
+            // Frames are chained by depth, the frame of a depth that was reached before is reused
+            JsonTapeFrame* top   = state->m_Top;
+            JsonTapeFrame* frame = top != nullptr ? top->m_Child : state->m_Frames;
+            if (frame == nullptr)
+            {
+                frame           = state->m_Scratch->Allocate<JsonTapeFrame>();
+                frame->m_Parent = top;
+                frame->m_Child  = nullptr;
+                if (top != nullptr)
+                    top->m_Child = frame;
+                else
+                    state->m_Frames = frame;
+            }
+
+            // The start word is completed when the container is closed
+            frame->m_Start     = (s32)(state->m_Cursor - state->m_Words);
+            frame->m_Count     = 0;
+            frame->m_IsObject  = is_object;
+            frame->m_SeenValue = false;
+            frame->m_SeenComma = false;
+            *state->m_Cursor++ = 0;
+            state->m_Top       = frame;
+            state->m_Depth += 1;
+            return true;
+        }
+
+        static bool JsonTapePop(JsonTapeState* state)
+        {
+            if (!JsonTapeReserve(state, 1))
+                return false;
+
+            JsonTapeFrame* frame = state->m_Top;
+            s32 const      end   = (s32)(state->m_Cursor - state->m_Words);
+            u64 const      count = (u64)(frame->m_Count < kJsonTapeCountMax ? frame->m_Count : kJsonTapeCountMax);
+
+            state->m_Words[frame->m_Start] = JsonTapeWord(frame->m_IsObject ? kJsonTapeObject : kJsonTapeArray, (count << 32) | (u32)end);
+            *state->m_Cursor++             = JsonTapeWord(frame->m_IsObject ? kJsonTapeObjectEnd : kJsonTapeArrayEnd, (u64)frame->m_Start);
+
+            state->m_Top = frame->m_Parent;
+            state->m_Depth -= 1;
+            return true;
+        }
+
+        enum EJsonTapeStep
+        {
+            kJsonTapeStepValue, // the container expects a value
+            kJsonTapeStepDone,  // the container is closed
+            kJsonTapeStepError,
+        };
+
+        // Count the member whose value was written (if any) and read up to the next member value, its name goes
+        // on the tape, or the end of the object
+        template <typename P> static EJsonTapeStep JsonTapeObjectStep(JsonTapeState* state, JsonTapeFrame* frame, bool added)
+        {
+            JsonLexerState* lexer = &state->m_Lexer;
+
+            if (added)
+            {
+                frame->m_Count += 1;
+                frame->m_SeenValue = true;
+                frame->m_SeenComma = false;
+            }
+
+            for (;;)
+            {
+                JsonLexeme l = JsonLexerNext<P>(lexer);
+
+                switch (l.m_Type)
+                {
+                    case kJsonLexString:
+                    {
+                        if (frame->m_SeenValue && !frame->m_SeenComma)
+                        {
+                            JsonTapeError(state, "missing ','");
+                            return kJsonTapeStepError;
+                        }
+
+                        if (!JsonLexerExpect<P>(lexer, kJsonLexNameSeparator))
+                        {
+                            JsonTapeError(state, "missing ':'");
+                            return kJsonTapeStepError;
+                        }
+
+                        if (!JsonTapeString(state, l))
+                            return kJsonTapeStepError;
+                        return kJsonTapeStepValue;
+                    }
+
+                    case kJsonLexEndObject: return kJsonTapeStepDone;
+
+                    case kJsonLexValueSeparator:
+                    {
+                        if (!frame->m_SeenValue)
+                        {
+                            JsonTapeError(state, "expected key name");
+                            return kJsonTapeStepError;
+                        }
+
+                        if (frame->m_SeenComma)
+                        {
+                            JsonTapeError(state, "duplicate comma");
+                            return kJsonTapeStepError;
+                        }
+
+                        frame->m_SeenValue = false;
+                        frame->m_SeenComma = true;
+                        break;
+                    }
+
+                    case kJsonLexError: return kJsonTapeStepError;
+
+                    default: JsonTapeError(state, "expected object to continue"); return kJsonTapeStepError;
+                }
+            }
+        }
+
+        // Count the element that was written (if any) and read up to the next element or the end of the array
+        template <typename P> static EJsonTapeStep JsonTapeArrayStep(JsonTapeState* state, JsonTapeFrame* frame, bool added)
+        {
+            JsonLexerState* lexer = &state->m_Lexer;
+
+            if (added)
+                frame->m_Count += 1;
+
+            JsonLexeme l = JsonLexerPeek<P>(lexer);
+
+            if (kJsonLexEndArray == l.m_Type)
+            {
+                JsonLexerSkip<P>(lexer);
+                return kJsonTapeStepDone;
+            }
+
+            if (frame->m_Count > 0)
+            {
+                if (kJsonLexValueSeparator != l.m_Type)
+                {
+                    JsonTapeError(state, "expected ','");
+                    return kJsonTapeStepError;
+                }
+
+                JsonLexerSkip<P>(lexer);
+            }
+
+            return kJsonTapeStepValue;
+        }
+
+        // Iterative, nested arrays and objects are frames on an explicit stack instead of recursive calls
+        template <typename P> static bool JsonTapeValueParse(JsonTapeState* state)
+        {
+            JsonLexerState* lexer = &state->m_Lexer;
+            for (;;)
+            {
+                // A value, either a scalar or the start of an array or object
+                bool       added = false;
+                JsonLexeme l     = JsonLexerPeek<P>(lexer);
+                if (kJsonLexBeginObject == l.m_Type || kJsonLexBeginArray == l.m_Type)
+                {
+                    if (!JsonTapePush(state, kJsonLexBeginObject == l.m_Type))
+                        return false;
+                    JsonLexerSkip<P>(lexer);
+                }
+                else
+                {
+                    if (!JsonTapeScalar<P>(state, l))
+                        return false;
+                    added = true;
+                }
+
+                // Count the value in its container, closing containers until one expects another value
+                while (state->m_Top != nullptr)
+                {
+                    JsonTapeFrame* frame = state->m_Top;
+                    EJsonTapeStep  step  = frame->m_IsObject ? JsonTapeObjectStep<P>(state, frame, added) : JsonTapeArrayStep<P>(state, frame, added);
+                    if (step == kJsonTapeStepError)
+                        return false;
+                    if (step == kJsonTapeStepValue)
+                        break;
+
+                    if (!JsonTapePop(state))
+                        return false;
+                    added = true;
+                }
+
+                if (state->m_Top == nullptr)
+                    return true;
+            }
+        }
+
+        template <typename P> static const JsonTape* JsonParseTape(char const* str, char const* end, JsonAllocator* allocator, JsonAllocator* strings, JsonAllocator* scratch, JsonParseOptions const& options, char const*& error_message)
+        {
+            JsonTapeState* state = scratch->Allocate<JsonTapeState>();
+            JsonLexerStateInit(&state->m_Lexer, str, end, strings, scratch);
+            state->m_Top          = nullptr;
+            state->m_Frames       = nullptr;
+            state->m_Depth        = 0;
+            state->m_MaxDepth     = options.m_MaxDepth;
+            state->m_ErrorMessage = nullptr;
+            state->m_Scratch      = scratch;
+
+            // The string offsets are relative to the current end of 'strings', the words may use all the memory that is
+            // left in 'allocator' and what they do not use is given back at the end
+            ASSERT(allocator != strings);
+            JsonTape* tape        = allocator->Allocate<JsonTape>();
+            char*     strings_end = nullptr;
+            char*     words_end   = nullptr;
+            state->m_Strings      = strings->CheckOut(strings_end);
+            state->m_Words        = (u64*)allocator->CheckOut(words_end);
+            state->m_Cursor       = state->m_Words;
+            state->m_End          = state->m_Words + ((words_end - (char*)state->m_Words) / (s64)sizeof(u64));
+
+            bool ok = tape != nullptr && JsonTapeValueParse<P>(state);
+            if (ok && !JsonLexerExpect<P>(&state->m_Lexer, kJsonLexEof))
+                ok = JsonTapeError(state, "data after document");
+
+            allocator->Commit((char*)(ok ? state->m_Cursor : state->m_Words));
+
+            error_message = nullptr;
+            if (!ok)
+            {
+                char const* msg = state->m_ErrorMessage != nullptr ? state->m_ErrorMessage : state->m_Lexer.m_ErrorMessage;
+                if (msg == nullptr)
+                    msg = "invalid document";
+                s32 const len    = ascii::strlen(msg);
+                char*     errmsg = scratch->AllocateArray<char>(len + 1);
+                nmem::memcpy(errmsg, msg, len);
+                errmsg[len]   = '\0';
+                error_message = errmsg;
+                return nullptr;
+            }
+
+            tape->m_Words   = state->m_Words;
+            tape->m_Count   = (s32)(state->m_Cursor - state->m_Words);
+            tape->m_Strings = state->m_Strings;
+            return tape;
+        }
+
+        const JsonTape* ParseTape(char const* str, char const* end, JsonAllocator* allocator, JsonAllocator* strings, JsonAllocator* scratch, char const*& error_message)
+        {
+            JsonParseOptions options;
+            return ParseTape(str, end, allocator, strings, scratch, options, error_message);
+        }
+
+        const JsonTape* ParseTape(char const* str, char const* end, JsonAllocator* allocator, JsonAllocator* strings, JsonAllocator* scratch, JsonParseOptions const& options, char const*& error_message)
+        {
+            if (options.m_Flags & kJsonParseValidateUtf8)
+                return JsonParseTape<JsonTapeLexer<JsonUtf8Validate>::Policy>(str, end, allocator, strings, scratch, options, error_message);
+            return JsonParseTape<JsonTapeLexer<JsonUtf8Trust>::Policy>(str, end, allocator, strings, scratch, options, error_message);
+        }
+
+    } // namespace njson
+} // namespace ncore
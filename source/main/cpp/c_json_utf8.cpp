@@ -0,0 +1,229 @@
+#include "ccore/c_target.h"
+#include "ccore/c_debug.h"
+#include "cbase/c_memory.h"
+#include "cjson/c_json_simd.h"
+#include "cjson/c_json_utf8.h"
+
+namespace ncore
+{
+    namespace njson
+    {
+        static char const* FindInvalidUtf8Scalar(char const* str, char const* end)
+        {
+            u64 const high_bits = 0x8080808080808080ull;
+            while (str < end)
+            {
+                // Skip ASCII 8 bytes at a time
+                while ((end - str) >= 8)
+                {
+                    u64 word;
+                    nmem::memcpy(&word, str, sizeof(word));
+                    if (word & high_bits)
+                        break;
+                    str += 8;
+                }
+                if (str >= end)
+                    break;
+
+                u8 const c = (u8)str[0];
+                if (c < 0x80)
+                {
+                    str += 1;
+                    continue;
+                }
+
+                // Length and valid range of the second byte, see Table 3-7 of the Unicode standard
+                s32 len = 0;
+                u8  lo  = 0x80;
+                u8  hi  = 0xBF;
+                if (c >= 0xC2 && c <= 0xDF)
+                {
+                    len = 2;
+                }
+                else if (c >= 0xE0 && c <= 0xEF)
+                {
+                    len = 3;
+                    if (c == 0xE0)
+                        lo = 0xA0; // overlong
+                    else if (c == 0xED)
+                        hi = 0x9F; // surrogates
+                }
+                else if (c >= 0xF0 && c <= 0xF4)
+                {
+                    len = 4;
+                    if (c == 0xF0)
+                        lo = 0x90; // overlong
+                    else if (c == 0xF4)
+                        hi = 0x8F; // above U+10FFFF
+                }
+                else
+                {
+                    return str;
+                }
+
+                if ((end - str) < len)
+                    return str;
+                u8 const c1 = (u8)str[1];
+                if (c1 < lo || c1 > hi)
+                    return str;
+                for (s32 i = 2; i < len; ++i)
+                {
+                    if (((u8)str[i] & 0xC0) != 0x80)
+                        return str;
+                }
+                str += len;
+            }
+            return end;
+        }
+
+#if defined(CJSON_SIMD_SSSE3)
+        // Lookup-table validation (Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte").
+        // Every pair of bytes is classified by the high nibble of the first byte, the low nibble of the first
+        // byte and the high nibble of the second byte, an error bit that survives the AND of the 3 lookups
+        // marks an invalid pair. Three and four byte sequences are checked for the right number of
+        // continuation bytes separately.
+        enum EUtf8Error
+        {
+            kUtf8TooShort     = 1 << 0, // 11______ 0_______ or 11______ 11______
+            kUtf8TooLong      = 1 << 1, // 0_______ 10______
+            kUtf8Overlong3    = 1 << 2, // 11100000 100_____
+            kUtf8TooLarge     = 1 << 3, // 11110100 1001____ and above
+            kUtf8Surrogate    = 1 << 4, // 11101101 101_____
+            kUtf8Overlong2    = 1 << 5, // 1100000_ 10______
+            kUtf8TooLarge1000 = 1 << 6, // 11110101 1000____ and above
+            kUtf8Overlong4    = 1 << 6, // 11110000 1000____
+            kUtf8TwoConts     = 1 << 7, // 10______ 10______
+            kUtf8Carry        = kUtf8TooShort | kUtf8TooLong | kUtf8TwoConts,
+        };
+
+        // clang-format off
+        static const u8 s_Utf8Byte1High[16] = {
+            kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, // 0_______
+            kUtf8TwoConts, kUtf8TwoConts, kUtf8TwoConts, kUtf8TwoConts,                                                   // 10______
+            kUtf8TooShort | kUtf8Overlong2,                                                                               // 1100____
+            kUtf8TooShort,                                                                                                // 1101____
+            kUtf8TooShort | kUtf8Overlong3 | kUtf8Surrogate,                                                              // 1110____
+            kUtf8TooShort | kUtf8TooLarge | kUtf8TooLarge1000 | kUtf8Overlong4                                            // 1111____
+        };
+
+        static const u8 s_Utf8Byte1Low[16] = {
+            kUtf8Carry | kUtf8Overlong3 | kUtf8Overlong2 | kUtf8Overlong4, // ____0000
+            kUtf8Carry | kUtf8Overlong2,                                   // ____0001
+            kUtf8Carry,                                                    // ____0010
+            kUtf8Carry,                                                    // ____0011
+            kUtf8Carry | kUtf8TooLarge,                                    // ____0100
+            kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,                // ____0101
+            kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,                // ____0110
+            kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,                // ____0111
+            kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,                // ____1000
+            kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,                // ____1001
+            kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,                // ____1010
+            kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,                // ____1011
+            kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,                // ____1100
+            kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000 | kUtf8Surrogate, // ____1101
+            kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,                // ____1110
+            kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,                // ____1111
+        };
+
+        static const u8 s_Utf8Byte2High[16] = {
+            kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort,      // 0_______
+            kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Overlong3 | kUtf8TooLarge1000 | kUtf8Overlong4,                         // 1000____
+            kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Overlong3 | kUtf8TooLarge,                                              // 1001____
+            kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Surrogate | kUtf8TooLarge,                                              // 1010____
+            kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Surrogate | kUtf8TooLarge,                                              // 1011____
+            kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort,                                                                  // 11______
+        };
+
+        // A block that ends with the lead byte of a sequence that continues in the next block
+        static const u8 s_Utf8MaxValue[16] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1};
+        // clang-format on
+
+        struct Utf8Checker
+        {
+            __m128i m_Error;
+            __m128i m_PrevInput;
+            __m128i m_PrevIncomplete;
+        };
+
+        static inline void Utf8CheckBlock(Utf8Checker& checker, __m128i input)
+        {
+            if (_mm_movemask_epi8(input) == 0)
+            {
+                // ASCII, only a sequence left open by the previous block can be an error
+                checker.m_Error = _mm_or_si128(checker.m_Error, checker.m_PrevIncomplete);
+            }
+            else
+            {
+                __m128i const nibble = _mm_set1_epi8(0x0F);
+                __m128i const prev1  = _mm_alignr_epi8(input, checker.m_PrevInput, 15);
+
+                __m128i const byte_1_high = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)s_Utf8Byte1High), _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+                __m128i const byte_1_low  = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)s_Utf8Byte1Low), _mm_and_si128(prev1, nibble));
+                __m128i const byte_2_high = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)s_Utf8Byte2High), _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+                __m128i const special     = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+                // The 3rd and 4th byte of a sequence must be continuation bytes, which 'special' reports as kUtf8TwoConts
+                __m128i const prev2       = _mm_alignr_epi8(input, checker.m_PrevInput, 14);
+                __m128i const prev3       = _mm_alignr_epi8(input, checker.m_PrevInput, 13);
+                __m128i const is_third    = _mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 0x80)));
+                __m128i const is_fourth   = _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 0x80)));
+                __m128i const must_be_23  = _mm_and_si128(_mm_or_si128(is_third, is_fourth), _mm_set1_epi8((char)0x80));
+                checker.m_Error           = _mm_or_si128(checker.m_Error, _mm_xor_si128(must_be_23, special));
+                checker.m_PrevIncomplete  = _mm_subs_epu8(input, _mm_loadu_si128((__m128i const*)s_Utf8MaxValue));
+            }
+            checker.m_PrevInput = input;
+        }
+
+        static inline bool Utf8HasError(__m128i error) { return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) != 0xFFFF; }
+
+        // The vector check only knows the block, locate the exact byte with the scalar check starting at
+        // the first character boundary in front of the previous block.
+        static char const* Utf8LocateError(char const* str, char const* block, char const* end)
+        {
+            char const* start = (block - str) > 16 ? block - 16 : str;
+            for (s32 i = 0; i < 3 && start > str && ((u8)*start & 0xC0) == 0x80; ++i)
+                --start;
+            return FindInvalidUtf8Scalar(start, end);
+        }
+
+        char const* FindInvalidUtf8(char const* str, char const* end)
+        {
+            Utf8Checker checker;
+            checker.m_Error          = _mm_setzero_si128();
+            checker.m_PrevInput      = _mm_setzero_si128();
+            checker.m_PrevIncomplete = _mm_setzero_si128();
+
+            char const* ptr = str;
+            while ((end - ptr) >= 16)
+            {
+                Utf8CheckBlock(checker, _mm_loadu_si128((__m128i const*)ptr));
+                if (Utf8HasError(checker.m_Error))
+                    return Utf8LocateError(str, ptr, end);
+                ptr += 16;
+            }
+
+            if (ptr < end)
+            {
+                // Pad the tail with zeros (ASCII), a truncated sequence at the end then shows up as too short
+                char tail[16];
+                nmem::memset(tail, 0, sizeof(tail));
+                nmem::memcpy(tail, ptr, end - ptr);
+                Utf8CheckBlock(checker, _mm_loadu_si128((__m128i const*)tail));
+            }
+            else
+            {
+                checker.m_Error = _mm_or_si128(checker.m_Error, checker.m_PrevIncomplete);
+            }
+
+            if (Utf8HasError(checker.m_Error))
+                return Utf8LocateError(str, ptr, end);
+            return end;
+        }
+#else
+        char const* FindInvalidUtf8(char const* str, char const* end) { return FindInvalidUtf8Scalar(str, end); }
+#endif
+
+        bool ValidateUtf8(char const* str, char const* end) { return FindInvalidUtf8(str, end) == end; }
+
+    } // namespace njson
+} // namespace ncore
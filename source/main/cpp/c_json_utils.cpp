@@ -1,8 +1,12 @@
 #include "cbase/c_allocator.h"
 #include "cbase/c_context.h"
+#include "cbase/c_memory.h"
 #include "cbase/c_printf.h"
 #include "cbase/c_runes.h"
+#include "cjson/c_json_simd.h"
+#include "cjson/c_json_charclass.h"
 #include "cjson/c_json_utils.h"
+#include "cjson/c_json_float.h"
 
 namespace ncore
 {
@@ -18,22 +22,23 @@ namespace ncore
             c.l = 0;
             if (c.c != 0)
             {
+                s64 const avail = end - str;
                 if (c.c < 0x80)
                 {
                     c.l = 1;
                 }
-                else if ((c.c >> 5) == 0x6)
+                else if ((c.c >> 5) == 0x6 && avail >= 2)
                 {
                     c.c = ((c.c << 6) & 0x7ff) + ((str[1]) & 0x3f);
                     c.l = 2;
                 }
-                else if ((c.c >> 4) == 0xe)
+                else if ((c.c >> 4) == 0xe && avail >= 3)
                 {
                     c.c = ((c.c << 12) & 0xffff) + (((str[1]) << 6) & 0xfff);
                     c.c += (str[2]) & 0x3f;
                     c.l = 3;
                 }
-                else if ((c.c >> 3) == 0x1e)
+                else if ((c.c >> 3) == 0x1e && avail >= 4)
                 {
                     c.c = ((c.c << 18) & 0x1fffff) + (((str[1]) << 12) & 0x3ffff);
                     c.c += ((str[2]) << 6) & 0xfff;
@@ -42,7 +47,7 @@ namespace ncore
                 }
                 else
                 {
-                    c.c = 0xFFFE; // illegal character
+                    c.c = 0xFFFE; // illegal or truncated character
                     c.l = -1;
                 }
             }
@@ -231,139 +236,138 @@ namespace ncore
             return true;
         }
 
+        // SWAR (SIMD within a register) digit runs, 8 ASCII characters are loaded into a u64 in memory order
+        static inline u64 JsonLoadEightChars(char const* str)
+        {
+            u64 chunk;
+            nmem::memcpy(&chunk, str, sizeof(chunk));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+            chunk = __builtin_bswap64(chunk);
+#endif
+            return chunk;
+        }
+
+        // True when all 8 characters are '0'-'9': the high nibbles must be 3, and adding 6 may not carry into them
+        static inline bool JsonIsEightDigits(u64 chunk) { return (((chunk & 0xF0F0F0F0F0F0F0F0ull) | (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull); }
+
+        // The value of 8 digits, pairs are combined into 2 digit values, then 4, then 8
+        static inline u32 JsonEightDigitsToU32(u64 chunk)
+        {
+            u64 const mask = 0x000000FF000000FFull;
+            u64 const mul1 = 0x000F424000000064ull; // 100 + (1000000 << 32)
+            u64 const mul2 = 0x0000271000000001ull; // 1 + (10000 << 32)
+            chunk -= 0x3030303030303030ull;
+            chunk = (chunk * 10) + (chunk >> 8);
+            chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+            return (u32)chunk;
+        }
+
+        static inline char const* JsonSkipDigits(char const* iter, char const* end)
+        {
+            while ((end - iter) >= 8 && JsonIsEightDigits(JsonLoadEightChars(iter)))
+                iter += 8;
+            while (iter < end && *iter >= '0' && *iter <= '9')
+                iter++;
+            return iter;
+        }
+
+        // Parses a number in a single pass, the number ends at the first character that cannot continue it
         bool ParseNumber(char const*& str, char const* _end, JsonNumber& out_number)
         {
             out_number.m_Type = kJsonNumber_unknown;
 
-            u64 integer = 0;
-            f64 number  = 0.0;
-
             const char* iter = str;
 
-            // Should we scan for the end of the number first?
-            const char* iter_end = iter;
-            while (iter_end < _end)
-            {
-                const char ce = PeekAsciiChar(iter_end, _end);
-                // whitespace, comma, array or object end indicates end of number
-                if (ascii::is_whitespace(ce) || ce == ',' || ce == ']' || ce == '}')
-                    break;
-                iter_end++;
-            }
+            JsonFloatDigits digits;
+            digits.m_Exponent = 0;
+            digits.m_Negative = false;
 
             // If the number is negative
-            s64  sign = 1;
-            char c    = PeekAsciiChar(iter, iter_end);
-            if (c == '-')
+            if (iter < _end && *iter == '-')
             {
-                sign = -1;
+                digits.m_Negative = true;
                 iter++;
             }
 
-            // Parse the integer part.
-            while (iter < iter_end)
+            // The integer part, 16 digits always fit in a u64, further digits are checked for overflow.
+            u64  integer     = 0;
+            bool overflow    = false;
+            digits.m_Integer = iter;
+            while ((_end - iter) >= 8 && (iter - digits.m_Integer) < 16)
             {
-                c = PeekAsciiChar(iter, iter_end);
-                if (c < '0' || c > '9')
-                {
+                u64 const chunk = JsonLoadEightChars(iter);
+                if (!JsonIsEightDigits(chunk))
                     break;
-                }
-                integer = integer * 10 + (c - '0');
+                integer = integer * 100000000 + JsonEightDigitsToU32(chunk);
+                iter += 8;
+            }
+            while (iter < _end && *iter >= '0' && *iter <= '9')
+            {
+                u64 const digit = (u64)(*iter - '0');
+                overflow        = overflow || integer > (0xFFFFFFFFFFFFFFFFull - digit) / 10;
+                integer         = integer * 10 + digit;
                 iter++;
             }
+            digits.m_IntegerEnd  = iter;
+            digits.m_Fraction    = iter;
+            digits.m_FractionEnd = iter;
 
-            number = (f64)integer;
+            bool is_float = false;
 
-            // Parse the decimal part.
-            c = PeekAsciiChar(iter, iter_end);
-            if (iter < iter_end && c == '.')
+            // The decimal part.
+            if (iter < _end && *iter == '.')
             {
                 iter++;
-                f64 decimal = 0.0;
-                f64 div     = 1.0;
-                while (iter < iter_end)
-                {
-                    c = PeekAsciiChar(iter, iter_end);
-                    if (c < '0' || c > '9')
-                    {
-                        break;
-                    }
-                    decimal = decimal * 10.0 + (c - '0');
-                    div *= 10.0;
-                    iter++;
-                }
-                number += decimal / div;
-
-                out_number.m_Type = kJsonNumber_f64;
-                out_number.m_F64  = number * (f64)sign;
+                digits.m_Fraction    = iter;
+                iter                 = JsonSkipDigits(iter, _end);
+                digits.m_FractionEnd = iter;
+                is_float             = true;
             }
 
-            // Parse the exponent part.
-            c = PeekAsciiChar(iter, iter_end);
-            if (iter < iter_end && (c == 'e' || c == 'E'))
+            // The exponent part, saturated far beyond the range of a f64.
+            if (iter < _end && (*iter == 'e' || *iter == 'E'))
             {
                 iter++;
 
-                s32 esign    = 1;
-                s32 exponent = 0;
-                c            = PeekAsciiChar(iter, iter_end);
-                if (iter < iter_end && (c == '+' || c == '-'))
+                bool negative_exponent = false;
+                if (iter < _end && (*iter == '+' || *iter == '-'))
                 {
-                    if (c == '-')
-                    {
-                        esign = -1;
-                    }
+                    negative_exponent = (*iter == '-');
                     iter++;
                 }
-                while (iter < iter_end)
+                s64 exponent = 0;
+                while (iter < _end && *iter >= '0' && *iter <= '9')
                 {
-                    c = PeekAsciiChar(iter, iter_end);
-                    if (c < '0' || c > '9')
-                    {
-                        break;
-                    }
-                    exponent = exponent * 10 + (c - '0');
+                    if (exponent < 0x100000)
+                        exponent = exponent * 10 + (*iter - '0');
                     iter++;
                 }
-                if (exponent > 308)
-                {
-                    exponent = 308;
-                }
-
-                // Adjust result on exponent esign
-                if (esign > 0)
-                {
-                    for (s32 i = 0; i < exponent; i++)
-                        number *= 10.0;
-                }
-                else
-                {
-                    for (s32 i = 0; i < exponent; i++)
-                        number /= 10.0;
-                }
-
-                out_number.m_Type = kJsonNumber_f64;
-                out_number.m_F64  = number;
+                digits.m_Exponent = negative_exponent ? -exponent : exponent;
+                is_float          = true;
             }
 
-            if (out_number.m_Type == kJsonNumber_unknown)
+            // An integer that does not fit in 64 bits is converted as a float
+            if (!is_float && !overflow)
             {
-                if (sign == 1)
+                if (!digits.m_Negative)
                 {
                     out_number.m_Type = kJsonNumber_u64;
-                    if (integer <= 9223372036854775807ul)
+                    if (integer <= 9223372036854775807ull)
                         out_number.m_Type = kJsonNumber_s64;
-                    out_number.m_U64 = (u64)integer;
+                    out_number.m_U64 = integer;
                 }
-                else
+                else if (integer <= 9223372036854775808ull)
                 {
                     out_number.m_Type = kJsonNumber_s64;
-                    out_number.m_S64  = (s64)sign * (s64)integer;
+                    out_number.m_U64  = 0 - integer;
                 }
             }
 
-            // Should iter not end up at iter_end, we have a problem?
-            ASSERT(iter <= iter_end);
+            if (out_number.m_Type == kJsonNumber_unknown)
+            {
+                out_number.m_Type = kJsonNumber_f64;
+                out_number.m_F64  = JsonDigitsToFloat64(digits);
+            }
 
             str = iter;
             return true;
@@ -454,6 +458,137 @@ namespace ncore
             }
         }
 
+        // clang-format off
+        static const char s_JsonDigitPairs[200] = {
+            '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+            '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+            '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+            '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+            '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+            '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+            '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+            '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+            '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+            '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9',
+        };
+
+        static const u64 s_JsonPowersOfTenU64[20] = {
+            1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+            10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull, 1000000000000000ull,
+            10000000000000000ull, 100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull,
+        };
+        // clang-format on
+
+        s32 JsonCountDigits(u64 value)
+        {
+            // log10(value) estimated from log2(value), 1233/4096 ~ log10(2), then corrected by one comparison
+            s32 const bits  = 64 - JsonCountLeadingZeros64(value | 1);
+            s32 const guess = (bits * 1233) >> 12;
+            return guess + (((value | 1) >= s_JsonPowersOfTenU64[guess]) ? 1 : 0);
+        }
+
+        // Writes exactly count digits of value, back to front two digits at a time
+        static inline void JsonWriteDigits(u64 value, char* str, s32 count)
+        {
+            char* iter = str + count;
+            while (value >= 100)
+            {
+                u32 const pair = (u32)(value % 100) * 2;
+                value /= 100;
+                iter -= 2;
+                iter[0] = s_JsonDigitPairs[pair];
+                iter[1] = s_JsonDigitPairs[pair + 1];
+            }
+            if (value >= 10)
+            {
+                iter -= 2;
+                iter[0] = s_JsonDigitPairs[value * 2];
+                iter[1] = s_JsonDigitPairs[value * 2 + 1];
+            }
+            else
+            {
+                *--iter = (char)('0' + value);
+            }
+        }
+
+        char* JsonFormatUInt64(u64 value, char* str, char const* end)
+        {
+            s32 const count = JsonCountDigits(value);
+            if ((end - str) >= count)
+            {
+                JsonWriteDigits(value, str, count);
+                return str + count;
+            }
+
+            // Not enough room, write what fits
+            char digits[20];
+            JsonWriteDigits(value, digits, count);
+            for (s32 i = 0; i < count && str < end; ++i)
+                *str++ = digits[i];
+            return str;
+        }
+
+        char* JsonFormatInt64(s64 value, char* str, char const* end)
+        {
+            if (value >= 0)
+                return JsonFormatUInt64((u64)value, str, end);
+            if (str >= end)
+                return str;
+            *str++ = '-';
+            return JsonFormatUInt64(0 - (u64)value, str, end);
+        }
+
+        char* JsonEscapeString(char const*& str, char const* str_end, char* out, char const* end)
+        {
+            static const char s_JsonHexDigits[] = "0123456789abcdef";
+
+            char const* src = str;
+            while (src < str_end)
+            {
+                // Plain content up to the next byte that needs an escape is copied as one run
+                char const* special = JsonFindStringSpecial(src, str_end);
+                s64         run     = special - src;
+                if (run > (end - out))
+                    run = end - out;
+                nmem::memcpy(out, src, run);
+                out += run;
+                src += run;
+                if (src != special || src == str_end)
+                    break;
+
+                char const c = *src;
+                char       esc;
+                switch (c)
+                {
+                    case '"': esc = '"'; break;
+                    case '\\': esc = '\\'; break;
+                    case '\b': esc = 'b'; break;
+                    case '\f': esc = 'f'; break;
+                    case '\n': esc = 'n'; break;
+                    case '\r': esc = 'r'; break;
+                    case '\t': esc = 't'; break;
+                    default: esc = 'u'; break;
+                }
+
+                s32 const len = (esc == 'u') ? 6 : 2;
+                if ((end - out) < len)
+                    break;
+                out[0] = '\\';
+                out[1] = esc;
+                if (esc == 'u')
+                {
+                    out[2] = '0';
+                    out[3] = '0';
+                    out[4] = s_JsonHexDigits[((u8)c) >> 4];
+                    out[5] = s_JsonHexDigits[((u8)c) & 0xF];
+                }
+                out += len;
+                src += 1;
+            }
+            str = src;
+            return out;
+        }
+
         inline static void json_write_str(char*& dst, char const* end, char const* str)
         {
             while (dst < end && *str != '\0')
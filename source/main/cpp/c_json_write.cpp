@@ -0,0 +1,305 @@
+#include "cbase/c_memory.h"
+#include "cjson/c_json_utils.h"
+#include "cjson/c_json_float.h"
+#include "cjson/c_json_parser.h"
+#include "cjson/c_json_write.h"
+
+namespace ncore
+{
+    namespace njson
+    {
+        static const char s_JsonWriteSpaces[] = "                                                                "; // 64
+
+        // The text goes into [m_Begin, m_End), a full buffer is flushed to the sink, counted when measuring
+        // or is an error when writing into a fixed buffer.
+        struct JsonWriter
+        {
+            char*                m_Begin;
+            char*                m_Cursor;
+            char*                m_End;
+            JsonWriteSink const* m_Sink;
+            bool                 m_Measure;
+            bool                 m_Failed;
+            bool                 m_Pretty;
+            s32                  m_Indent;
+            s32                  m_IndentSpaces;
+            s64                  m_Flushed; // bytes handed to the sink or counted
+
+            void Init(char* begin, char* end, JsonWriteOptions const& options)
+            {
+                m_Begin        = begin;
+                m_Cursor       = begin;
+                m_End          = end;
+                m_Sink         = nullptr;
+                m_Measure      = false;
+                m_Failed       = false;
+                m_Pretty       = (options.m_Flags & kJsonWritePretty) != 0;
+                m_Indent       = 0;
+                m_IndentSpaces = options.m_IndentSpaces > 0 ? options.m_IndentSpaces : 0;
+                m_Flushed      = 0;
+            }
+
+            bool Flush()
+            {
+                if (m_Failed)
+                    return false;
+
+                s64 const n = m_Cursor - m_Begin;
+                if (m_Sink != nullptr)
+                {
+                    if (n > 0 && !m_Sink->m_Flush(m_Sink->m_User, m_Begin, (s32)n))
+                        m_Failed = true;
+                }
+                else if (!m_Measure)
+                {
+                    m_Failed = true;
+                }
+
+                if (m_Failed)
+                    return false;
+                m_Flushed += n;
+                m_Cursor = m_Begin;
+                return true;
+            }
+
+            inline void Put(char c)
+            {
+                if (m_Cursor == m_End && !Flush())
+                    return;
+                *m_Cursor++ = c;
+            }
+
+            void Put(char const* str, s64 len)
+            {
+                while (len > 0)
+                {
+                    if (m_Cursor == m_End && !Flush())
+                        return;
+                    s64 n = m_End - m_Cursor;
+                    if (n > len)
+                        n = len;
+                    nmem::memcpy(m_Cursor, str, n);
+                    m_Cursor += n;
+                    str += n;
+                    len -= n;
+                }
+            }
+
+            void PutString(char const* str, char const* end)
+            {
+                Put('"');
+                while (str < end)
+                {
+                    m_Cursor = JsonEscapeString(str, end, m_Cursor, m_End);
+                    if (str < end && !Flush())
+                        return;
+                }
+                Put('"');
+            }
+
+            void PutNumber(JsonNumberValue const* number)
+            {
+                JsonNumber const value = JsonNumberValueResolve(number);
+
+                // Format in place when there is room for any number, otherwise into a temporary
+                char  tmp[kJsonFloatMaxChars];
+                char* str = (m_End - m_Cursor) >= kJsonFloatMaxChars ? m_Cursor : tmp;
+                char* end;
+                switch (value.m_Type)
+                {
+                    case kJsonNumber_s64: end = JsonFormatInt64(value.m_S64, str, str + kJsonFloatMaxChars); break;
+                    case kJsonNumber_u64: end = JsonFormatUInt64(value.m_U64, str, str + kJsonFloatMaxChars); break;
+                    case kJsonNumber_f64: end = JsonFormatFloat64(value.m_F64, str, str + kJsonFloatMaxChars); break;
+                    default: m_Failed = true; return; // lazy number text that is not a number
+                }
+
+                if (str == m_Cursor)
+                    m_Cursor = end;
+                else
+                    Put(tmp, end - tmp);
+            }
+
+            void NewLine()
+            {
+                if (!m_Pretty)
+                    return;
+                Put('\n');
+                s32 n = m_Indent;
+                while (n > 64)
+                {
+                    Put(s_JsonWriteSpaces, 64);
+                    n -= 64;
+                }
+                Put(s_JsonWriteSpaces, n);
+            }
+        };
+
+        // An array or object that is being written, m_Index is the element or member that is written next
+        struct JsonWriteFrame
+        {
+            JsonValue const* m_Value;
+            s32              m_Index;
+        };
+
+        // The document is walked with an explicit stack of 'max_depth' frames, a document that is nested deeper is not written
+        static void JsonWriteWalk(JsonWriter& w, JsonValue const* root, JsonWriteFrame* stack, s32 max_depth)
+        {
+            s32              depth = 0;
+            JsonValue const* value = root;
+
+            for (;;)
+            {
+                // Write the value, an array or object with content is opened and continued below
+                if (value != nullptr)
+                {
+                    switch (value->m_Type)
+                    {
+                        case JsonValue::kNull: w.Put("null", 4); break;
+                        case JsonValue::kBoolean:
+                            if (value->m_Value.m_Boolean.m_Boolean)
+                                w.Put("true", 4);
+                            else
+                                w.Put("false", 5);
+                            break;
+                        case JsonValue::kNumber: w.PutNumber(&value->m_Value.m_Number); break;
+                        case JsonValue::kString: w.PutString(value->m_Value.m_String.m_String, value->m_Value.m_String.m_End); break;
+                        case JsonValue::kArray:
+                        case JsonValue::kObject:
+                        {
+                            bool const is_array = value->m_Type == JsonValue::kArray;
+                            s32 const  count    = is_array ? value->m_Value.m_Array.m_Count : value->m_Value.m_Object.m_Count;
+                            if (count == 0)
+                            {
+                                w.Put(is_array ? "[]" : "{}", 2);
+                                break;
+                            }
+                            if (depth == max_depth)
+                            {
+                                w.m_Failed = true;
+                                return;
+                            }
+                            w.Put(is_array ? '[' : '{');
+                            w.m_Indent += w.m_IndentSpaces;
+                            stack[depth].m_Value = value;
+                            stack[depth].m_Index = 0;
+                            depth += 1;
+                            break;
+                        }
+                        default: ASSERT(false); break;
+                    }
+                    value = nullptr;
+                }
+
+                if (w.m_Failed || depth == 0)
+                    return;
+
+                // The next element or member of the innermost container, or its end
+                JsonWriteFrame& frame = stack[depth - 1];
+                if (frame.m_Value->m_Type == JsonValue::kArray)
+                {
+                    JsonArrayValue const& array = frame.m_Value->m_Value.m_Array;
+                    if (frame.m_Index == array.m_Count)
+                    {
+                        w.m_Indent -= w.m_IndentSpaces;
+                        w.NewLine();
+                        w.Put(']');
+                        depth -= 1;
+                        continue;
+                    }
+                    if (frame.m_Index > 0)
+                        w.Put(',');
+                    w.NewLine();
+                    value = array.m_Values[frame.m_Index++];
+                }
+                else
+                {
+                    JsonObjectValue const& object = frame.m_Value->m_Value.m_Object;
+                    if (frame.m_Index == object.m_Count)
+                    {
+                        w.m_Indent -= w.m_IndentSpaces;
+                        w.NewLine();
+                        w.Put('}');
+                        depth -= 1;
+                        continue;
+                    }
+                    JsonNamedValue const& member = object.m_Members[frame.m_Index++];
+                    if (frame.m_Index > 1)
+                        w.Put(',');
+                    w.NewLine();
+                    w.PutString(member.m_Name, member.m_NameEnd);
+                    if (w.m_Pretty)
+                        w.Put(": ", 2);
+                    else
+                        w.Put(':');
+                    value = member.m_Value;
+                }
+            }
+        }
+
+        static void JsonWriteDocument(JsonWriter& w, JsonValue const* root, JsonWriteOptions const& options)
+        {
+            JsonAllocator* scratch = options.m_Scratch;
+            if (scratch == nullptr)
+            {
+                JsonWriteFrame stack[kJsonDefaultMaxDepth];
+                JsonWriteWalk(w, root, stack, options.m_MaxDepth < kJsonDefaultMaxDepth ? options.m_MaxDepth : kJsonDefaultMaxDepth);
+                return;
+            }
+
+            // The frames are given back to scratch when the document is written
+            JsonAllocatorScope scope(scratch);
+            s32 const          max_depth = options.m_MaxDepth > 0 ? options.m_MaxDepth : 0;
+            JsonWriteFrame*    stack     = (JsonWriteFrame*)scratch->Reserve(sizeof(JsonWriteFrame) * max_depth);
+            if (stack == nullptr)
+            {
+                w.m_Failed = true;
+                return;
+            }
+            scratch->Commit((char*)(stack + max_depth));
+            JsonWriteWalk(w, root, stack, max_depth);
+        }
+
+        char* Write(JsonValue const* value, char* str, char const* end, JsonWriteOptions const& options)
+        {
+            ASSERT(value != nullptr);
+            if (str >= end)
+                return nullptr;
+
+            // Keep one byte for the terminator
+            JsonWriter w;
+            w.Init(str, (char*)end - 1, options);
+            JsonWriteDocument(w, value, options);
+            if (w.m_Failed)
+                return nullptr;
+            *w.m_Cursor = '\0';
+            return w.m_Cursor;
+        }
+
+        s64 WriteSize(JsonValue const* value, JsonWriteOptions const& options)
+        {
+            ASSERT(value != nullptr);
+
+            char       buffer[256];
+            JsonWriter w;
+            w.Init(buffer, buffer + sizeof(buffer), options);
+            w.m_Measure = true;
+            JsonWriteDocument(w, value, options);
+            if (w.m_Failed)
+                return -1;
+            return w.m_Flushed + (w.m_Cursor - w.m_Begin);
+        }
+
+        bool Write(JsonValue const* value, JsonWriteSink const& sink, JsonWriteOptions const& options)
+        {
+            ASSERT(value != nullptr);
+            ASSERT(sink.m_BufferSize >= kJsonWriteSinkMinSize);
+
+            JsonWriter w;
+            w.Init(sink.m_Buffer, sink.m_Buffer + sink.m_BufferSize, options);
+            w.m_Sink = &sink;
+            JsonWriteDocument(w, value, options);
+            return w.Flush();
+        }
+
+    } // namespace njson
+} // namespace ncore
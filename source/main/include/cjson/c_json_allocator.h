@@ -20,6 +20,7 @@ namespace ncore
             char* Allocate(s64 size, s16 alignment);
 
             char* CheckOut(char*& end);
+            char* Reserve(s64 size); // like CheckOut with room for at least 'size' bytes, nullptr when there is not enough
             void  Commit(char* ptr);
 
             void Reset();
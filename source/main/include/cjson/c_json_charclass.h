@@ -0,0 +1,49 @@
+#ifndef __CJSON_JSON_CHARCLASS_H__
+#define __CJSON_JSON_CHARCLASS_H__
+#include "ccore/c_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+namespace ncore
+{
+    namespace njson
+    {
+        // Byte classes of JSON text, JSON whitespace and all syntax characters are ASCII so a lexer
+        // never needs to decode UTF-8 to classify a byte.
+        enum EJsonCharClass
+        {
+            kJsonCharWhitespace = 0x01, // ' ', '\t', '\n', '\r'
+            kJsonCharOperator   = 0x02, // { } [ ] , :
+            kJsonCharDigit      = 0x04, // 0-9
+            kJsonCharNumber     = 0x08, // 0-9 - + . e E
+            kJsonCharLiteral    = 0x10, // first byte of true, false, null
+            kJsonCharAlpha      = 0x20, // a-z A-Z
+        };
+
+        extern const u8 g_JsonCharClass[256];
+
+        inline bool JsonIsWhitespace(char c) { return (g_JsonCharClass[(u8)c] & kJsonCharWhitespace) != 0; }
+        inline bool JsonIsOperator(char c) { return (g_JsonCharClass[(u8)c] & kJsonCharOperator) != 0; }
+        inline bool JsonIsDigit(char c) { return (g_JsonCharClass[(u8)c] & kJsonCharDigit) != 0; }
+        inline bool JsonIsAlpha(char c) { return (g_JsonCharClass[(u8)c] & kJsonCharAlpha) != 0; }
+
+        // First '"', '\\' or control byte (< 0x20) in [str, end), or 'end' when there is none. Everything
+        // before it is plain string content that can be copied as is.
+        char const* JsonFindStringSpecial(char const* str, char const* end);
+
+        // Number of elements of the array whose content starts at 'str' (just after the '['), when it only contains numbers. Returns -1
+        // when the array contains anything else or is not closed, this is a byte scan that does not validate the numbers.
+        s32 JsonCountNumberArray(char const* str, char const* end);
+
+        // Number of '\n' bytes in [str, end), counts 16/32 bytes at a time
+        s32 JsonCountNewlines(char const* str, char const* end);
+
+        // Line and column (both starting at 1) of 'pos' in the text that starts at 'begin', this is only
+        // computed when an error is reported so the lexers do not have to track it.
+        void JsonTextPosition(char const* begin, char const* pos, s32& out_line, s32& out_column);
+
+    } // namespace njson
+} // namespace ncore
+
+#endif // __CJSON_JSON_CHARCLASS_H__
@@ -584,6 +584,7 @@ namespace ncore
             inline bool  is_unsigned_integer() const { return (m_descr->m_type & (JsonType::TypeUInt8 | JsonType::TypeUInt16 | JsonType::TypeUInt32 | JsonType::TypeUInt64)) != 0; }
             inline bool  is_signed_integer() const { return (m_descr->m_type & (JsonType::TypeInt8 | JsonType::TypeInt16 | JsonType::TypeInt32 | JsonType::TypeInt64)) != 0; }
             inline bool  is_integer() const { return is_unsigned_integer() || is_signed_integer(); }
+            inline bool  is_signed() const { return (m_descr->m_type & JsonType::TypeSigned) == JsonType::TypeSigned; }
             inline bool  is_f32() const { return (m_descr->m_type & JsonType::TypeF32) == JsonType::TypeF32; }
             inline bool  is_f64() const { return (m_descr->m_type & JsonType::TypeF64) == JsonType::TypeF64; }
             inline bool  is_float() const { return (m_descr->m_type & (JsonType::TypeF32 | JsonType::TypeF64)) != 0; }
@@ -625,6 +626,9 @@ namespace ncore
 
         bool JsonDecode(char const* json, char const* json_end, JsonObject& json_root, JsonAllocator* allocator, JsonAllocator* scratch, char const*& error_message);
 
+        // Arrays and objects may be nested up to 'max_depth' levels (default 512), a deeper document is an error.
+        bool JsonDecode(char const* json, char const* json_end, JsonObject& json_root, JsonAllocator* allocator, JsonAllocator* scratch, s32 max_depth, char const*& error_message);
+
     } // namespace njson
 } // namespace ncore
 
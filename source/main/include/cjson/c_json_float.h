@@ -0,0 +1,47 @@
+#ifndef __CJSON_JSON_FLOAT_H__
+#define __CJSON_JSON_FLOAT_H__
+#include "ccore/c_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+namespace ncore
+{
+    namespace njson
+    {
+        // The parts of a number in JSON notation, [m_Integer, m_IntegerEnd) and [m_Fraction, m_FractionEnd)
+        // only contain the digits '0'-'9', m_Exponent is the value that follows 'e' or 'E'.
+        struct JsonFloatDigits
+        {
+            char const* m_Integer;
+            char const* m_IntegerEnd;
+            char const* m_Fraction;
+            char const* m_FractionEnd;
+            s64         m_Exponent;
+            bool        m_Negative;
+        };
+
+        // Correctly rounded (round to nearest, ties to even) decimal to binary64 conversion. The first 19
+        // significant digits are converted with the Eisel-Lemire algorithm, a 64x128 bit multiplication with
+        // a truncated power of five, which decides almost every input in constant time. Inputs that it
+        // cannot decide (more than 19 digits close to a halfway point, some subnormals) are converted with
+        // exact big decimal arithmetic. Values too large for a f64 are returned as infinity.
+        f64 JsonDigitsToFloat64(JsonFloatDigits const& digits);
+
+        // The longest text that JsonFormatFloat64 and JsonFormatFloat32 can write
+        enum
+        {
+            kJsonFloatMaxChars = 32
+        };
+
+        // Writes the shortest decimal that parses back to exactly the same value (Schubfach), in fixed notation
+        // when the decimal point is within 21 digits of the first digit (always with a fraction, '1.0') and in
+        // exponent notation otherwise ('1e21', '5e-324'). Infinity and NaN are written as 'null'. The text is
+        // truncated at end, it is not terminated, the return value is the end of the written text.
+        char* JsonFormatFloat64(f64 value, char* str, char const* end);
+        char* JsonFormatFloat32(f32 value, char* str, char const* end);
+
+    } // namespace njson
+} // namespace ncore
+
+#endif // __CJSON_JSON_FLOAT_H__
@@ -0,0 +1,256 @@
+#ifndef __CJSON_JSON_LEXER_H__
+#define __CJSON_JSON_LEXER_H__
+#include "ccore/c_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include "cjson/c_json_utils.h"
+#include "cjson/c_json_structural.h"
+
+namespace ncore
+{
+    namespace njson
+    {
+        struct JsonAllocator;
+
+        enum JsonLexemeType
+        {
+            kJsonLexError          = -1,
+            kJsonLexInvalid        = 0,
+            kJsonLexString         = 1,
+            kJsonLexValueSeparator = 3,
+            kJsonLexNameSeparator  = 4,
+            kJsonLexBeginObject    = 5,
+            kJsonLexBeginArray     = 6,
+            kJsonLexEndObject      = 7,
+            kJsonLexEndArray       = 8,
+            kJsonLexBoolean        = 9,
+            kJsonLexNull           = 10,
+            kJsonLexEof            = 11,
+            kJsonLexNumber         = 12,
+        };
+
+        struct JsonString
+        {
+            u32         m_Len;
+            const char* m_Str;
+        };
+
+        struct JsonLexeme
+        {
+            JsonLexeme() : m_Type(kJsonLexInvalid), m_Number() {}
+            JsonLexeme(JsonLexemeType type) : m_Type(type), m_Number() {}
+            JsonLexeme(JsonLexemeType type, JsonNumber number) : m_Type(type), m_Number(number) {}
+            JsonLexeme(JsonLexemeType type, const char* str, const char* end) : m_Type(type), m_Number()
+            {
+                m_String.m_Len = (u32)(end - str);
+                m_String.m_Str = str;
+            }
+
+            JsonLexemeType m_Type;
+            union
+            {
+                JsonNumber m_Number; // converted numbers and booleans
+                JsonString m_String; // strings, and the text of numbers and literals when they are not converted
+            };
+        };
+
+        // The lexer does not look at every byte, it walks the offsets produced by the structural index
+        // (see c_json_structural.h) one block of 64 bytes at a time. The token end is thus known before a
+        // token is lexed, the policies only have to convert [str, end).
+        struct JsonLexerState
+        {
+            const char*         m_Begin;
+            const char*         m_Cursor;
+            char const*         m_End;
+            const char*         m_Text;    // positions are reported in this text, m_Begin unless a part of it is lexed
+            JsonAllocator*      m_Alloc;   // unescaped strings
+            JsonAllocator*      m_Scratch; // error message
+            JsonStructuralState m_Structural;
+            u32                 m_Offsets[64];
+            s32                 m_OffsetIndex;
+            s32                 m_OffsetCount;
+            JsonLexeme          m_Lexeme;
+            char*               m_ErrorMessage;
+        };
+
+        void JsonLexerStateInit(JsonLexerState* self, char const* buffer, char const* end, JsonAllocator* alloc, JsonAllocator* scratch);
+        void JsonLexerPosition(JsonLexerState const* state, s32& out_line, s32& out_column); // position of the cursor, only used for error reporting
+
+        // ----------------------------------------------------------------------------------------------------------
+        // Lexer policies, a lexer is instantiated with one policy of each kind:
+        // - String: how the content of a string is delivered
+        // - Number: raw text or converted numbers and literals
+        // - Utf8:   validate the content of strings or trust the input
+
+        struct JsonStringSpan // the raw text in the input, escape sequences are not processed
+        {
+            static JsonLexeme Lex(JsonLexerState* state, char const* str, char const* end);
+        };
+        struct JsonStringCopy // unescaped into the allocator and NUL terminated
+        {
+            static JsonLexeme Lex(JsonLexerState* state, char const* str, char const* end);
+        };
+        struct JsonStringBorrow // strings without escapes point into the input (not NUL terminated), others are copied
+        {
+            static JsonLexeme Lex(JsonLexerState* state, char const* str, char const* end);
+        };
+        struct JsonStringInSitu // unescaped and NUL terminated in the (mutable) input
+        {
+            static JsonLexeme Lex(JsonLexerState* state, char const* str, char const* end);
+        };
+        struct JsonStringPrefixed // unescaped into the allocator after its u32 length and NUL terminated
+        {
+            static JsonLexeme Lex(JsonLexerState* state, char const* str, char const* end);
+        };
+
+        struct JsonNumberRaw // numbers and literals as text
+        {
+            static JsonLexeme Number(JsonLexerState* state, char const* str, char const* end);
+            static JsonLexeme Literal(JsonLexerState* state, char const* str, char const* end);
+        };
+        struct JsonNumberConvert // numbers parsed into a JsonNumber, booleans as a JsonNumber of type bool
+        {
+            static JsonLexeme Number(JsonLexerState* state, char const* str, char const* end);
+            static JsonLexeme Literal(JsonLexerState* state, char const* str, char const* end);
+        };
+
+        struct JsonNumberLazy // numbers as text, literals converted
+        {
+            static JsonLexeme Number(JsonLexerState* state, char const* str, char const* end);
+            static JsonLexeme Literal(JsonLexerState* state, char const* str, char const* end);
+        };
+
+        struct JsonUtf8Trust
+        {
+            static inline bool Check(char const*, char const*) { return true; }
+        };
+        struct JsonUtf8Validate
+        {
+            static bool Check(char const* str, char const* end);
+        };
+
+        template <typename TString, typename TNumber, typename TUtf8> struct JsonLexerPolicy
+        {
+            typedef TString String;
+            typedef TNumber Number;
+            typedef TUtf8   Utf8;
+        };
+
+        // ----------------------------------------------------------------------------------------------------------
+        // Lexer core, shared by all instantiations
+
+        enum EJsonToken
+        {
+            kJsonTokenOther       = 0, // most likely an invalid literal
+            kJsonTokenString      = 1,
+            kJsonTokenNumber      = 2,
+            kJsonTokenLiteral     = 3,
+            kJsonTokenBeginObject = 4,
+            kJsonTokenEndObject   = 5,
+            kJsonTokenBeginArray  = 6,
+            kJsonTokenEndArray    = 7,
+            kJsonTokenValueSep    = 8,
+            kJsonTokenNameSep     = 9,
+            kJsonTokenEnd         = 10, // '\0'
+        };
+
+        extern const u8 g_JsonTokenClass[256]; // first byte of a token -> EJsonToken
+
+        char const* JsonLexerNextToken(JsonLexerState* state); // start of the next token, nullptr at the end of the document
+        char const* JsonLexerTokenEnd(JsonLexerState* state);  // end of the token at the cursor
+        char const* JsonLexerStringEnd(JsonLexerState* state); // closing quote of the string at the cursor, nullptr if there is none
+        JsonLexeme  JsonLexerError(JsonLexerState* state, const char* error);
+        JsonLexeme  JsonLexerEof(JsonLexerState* state);
+
+        // Unescape [str, end) into scratch without committing it, the result is valid until the next scratch allocation.
+        // Returns nullptr on an illegal escape sequence or when scratch is too small.
+        char const* JsonLexerUnescapeScratch(JsonLexerState* state, char const* str, char const* end, char const*& out_end);
+
+        // Skip the rest of the array or object whose begin was the last token, only the brackets are looked at and
+        // nothing in between is checked. Returns the end of the container (one past its closing bracket), or nullptr
+        // when the document ends before it is closed.
+        char const* JsonLexerSkipContainer(JsonLexerState* state);
+
+        template <typename P> JsonLexeme JsonLexerFetchNext(JsonLexerState* state)
+        {
+            char const* p = JsonLexerNextToken(state);
+            if (p == nullptr)
+                return JsonLexerEof(state);
+
+            switch (g_JsonTokenClass[(u8)*p])
+            {
+                case kJsonTokenString:
+                {
+                    char const* end = JsonLexerStringEnd(state);
+                    if (end == nullptr)
+                        return JsonLexerError(state, "end of file inside string");
+                    if (!P::Utf8::Check(p + 1, end))
+                        return JsonLexerError(state, "invalid UTF-8 in string");
+                    return P::String::Lex(state, p + 1, end);
+                }
+                case kJsonTokenNumber: return P::Number::Number(state, p, JsonLexerTokenEnd(state));
+                case kJsonTokenBeginObject: state->m_Cursor = p + 1; return JsonLexeme(kJsonLexBeginObject);
+                case kJsonTokenEndObject: state->m_Cursor = p + 1; return JsonLexeme(kJsonLexEndObject);
+                case kJsonTokenBeginArray: state->m_Cursor = p + 1; return JsonLexeme(kJsonLexBeginArray);
+                case kJsonTokenEndArray: state->m_Cursor = p + 1; return JsonLexeme(kJsonLexEndArray);
+                case kJsonTokenValueSep: state->m_Cursor = p + 1; return JsonLexeme(kJsonLexValueSeparator);
+                case kJsonTokenNameSep: state->m_Cursor = p + 1; return JsonLexeme(kJsonLexNameSeparator);
+                case kJsonTokenEnd: return JsonLexerEof(state);
+                case kJsonTokenLiteral:
+                default: // very likely an error
+                    return P::Number::Literal(state, p, JsonLexerTokenEnd(state));
+            }
+        }
+
+        template <typename P> JsonLexeme JsonLexerPeek(JsonLexerState* state)
+        {
+            if (kJsonLexInvalid == state->m_Lexeme.m_Type)
+            {
+                state->m_Lexeme = JsonLexerFetchNext<P>(state);
+            }
+
+            return state->m_Lexeme;
+        }
+
+        template <typename P> JsonLexeme JsonLexerNext(JsonLexerState* state)
+        {
+            if (kJsonLexInvalid != state->m_Lexeme.m_Type)
+            {
+                JsonLexeme result      = state->m_Lexeme;
+                state->m_Lexeme.m_Type = kJsonLexInvalid;
+                return result;
+            }
+
+            return JsonLexerFetchNext<P>(state);
+        }
+
+        template <typename P> void JsonLexerSkip(JsonLexerState* state)
+        {
+            if (kJsonLexInvalid != state->m_Lexeme.m_Type)
+            {
+                state->m_Lexeme.m_Type = kJsonLexInvalid;
+                return;
+            }
+
+            JsonLexerNext<P>(state);
+        }
+
+        template <typename P> bool JsonLexerExpect(JsonLexerState* state, JsonLexemeType type, JsonLexeme* out = nullptr)
+        {
+            JsonLexeme l = JsonLexerNext<P>(state);
+            if (l.m_Type == type)
+            {
+                if (out)
+                    *out = l;
+                return true;
+            }
+
+            return false;
+        }
+
+    } // namespace njson
+} // namespace ncore
+
+#endif // __CJSON_JSON_LEXER_H__
@@ -7,12 +7,14 @@
 
 #include "ccore/c_debug.h"
 #include "cjson/c_json_allocator.h"
+#include "cjson/c_json_utils.h"
 
 namespace ncore
 {
     namespace njson
     {
         struct JsonAllocator;
+        struct JsonStringPool;
 
         struct JsonValue;
 
@@ -21,46 +23,60 @@ namespace ncore
             bool m_Boolean;
         };
 
+        // Integers keep their exact value (kJsonNumber_s64 or kJsonNumber_u64), only numbers with a fraction or exponent are f64.
+        // A lazy number (kJsonParseLazyNumbers) is stored as its text and converted on first access, see JsonNumberValueResolve.
         struct JsonNumberValue
         {
-            u32 m_NumberType;
+            u32 m_NumberType; // JsonNumberType, kJsonNumber_unknown for a lazy number that was not converted yet
+            u32 m_TextLen;    // lazy number, length of m_Text
             union
             {
-                f64 m_F64;
-                u64 m_U64;
-                s64 m_S64;
+                f64         m_F64;
+                u64         m_U64;
+                s64         m_S64;
+                const char* m_Text; // lazy number, points into the input
             };
         };
 
+        // The value of a number, a lazy number is converted by the first call and the result replaces its text. This writes to the
+        // document, so the first access of a lazy number is not thread-safe. The text of a lazy number is not checked when it is
+        // parsed, when it is not a number the value is kJsonNumber_unknown.
+        JsonNumber JsonNumberValueResolve(JsonNumberValue const* number);
+
         struct JsonStringValue
         {
             const char* m_String;
             const char* m_End;
         };
 
-        struct JsonLinkedValue
-        {
-            const JsonValue* m_Value;
-            JsonLinkedValue* m_Next;
-        };
-
+        // The elements are contiguous, in document order
         struct JsonArrayValue
         {
-            i32              m_Count;
-            JsonLinkedValue* m_LinkedList;
+            i32                     m_Count;
+            const JsonValue* const* m_Values;
         };
 
         struct JsonNamedValue
         {
             const char*      m_Name;
+            const char*      m_NameEnd;
             const JsonValue* m_Value;
-            JsonNamedValue*  m_Next;
+            u32              m_Hash; // JsonHashName of the name
         };
 
+        // The members are contiguous, in document order. An object with an index (see kJsonParseIndexObjects) is followed
+        // by an open addressing hash table of (m_IndexMask + 1) u32 slots, a slot holds a member index + 1 or 0 when empty.
         struct JsonObjectValue
         {
-            i32             m_Count;
-            JsonNamedValue* m_LinkedList;
+            i32                   m_Count;
+            u32                   m_IndexMask; // 0 when the object has no index
+            const JsonNamedValue* m_Members;
+        };
+
+        // Objects with at least this many members get an index when parsing with kJsonParseIndexObjects
+        enum
+        {
+            kJsonObjectIndexMinMembers = 16,
         };
 
         struct JsonValue
@@ -101,11 +117,17 @@ namespace ncore
 
             bool        GetBoolean() const;
             double      GetNumber() const;
+            s64         GetInt64() const;  // exact for integers, a f64 is truncated
+            u64         GetUInt64() const; // exact for integers, a f64 is truncated
             const char* GetString() const;
             bool        GetColor(u32& color) const;
 
-            const JsonLinkedValue* Head(i32& count) const;
-            const JsonValue*       Find(const char* key) const;
+            const JsonValue* const* Elements(i32& count) const;
+            const JsonValue*        At(i32 index) const; // nullptr when the index is out of range
+            const JsonValue*        Find(const char* key) const; // the last member with this name
+            const JsonValue*        Find(const char* key, s32 len) const;
+            const JsonValue*        Find(const char* key, s32 len, u32 hash) const; // hash is JsonHashName(key, key + len)
+            const JsonValue*        FindPooled(const char* key) const; // key from the m_KeyPool of the parse, compared by pointer
         };
 
         inline const JsonObjectValue* JsonValue::AsObject() const
@@ -143,19 +165,48 @@ namespace ncore
             return nullptr;
         }
 
-        inline const JsonLinkedValue* JsonValue::Head(i32& count) const
+        inline const JsonValue* const* JsonValue::Elements(i32& count) const
         {
             const JsonArrayValue* array = AsArray();
             ASSERT(array);
             count = array->m_Count;
-            return array->m_LinkedList;
+            return array->m_Values;
+        }
+
+        inline const JsonValue* JsonValue::At(i32 index) const
+        {
+            const JsonArrayValue* array = AsArray();
+            ASSERT(array);
+            if (index < 0 || index >= array->m_Count)
+                return nullptr;
+            return array->m_Values[index];
         }
 
         inline double JsonValue::GetNumber() const
         {
             const JsonNumberValue* num = AsNumber();
             ASSERT(num);
-            return num->m_F64;
+            if (num->m_NumberType == kJsonNumber_f64)
+                return num->m_F64;
+            return JsonNumberAsFloat64(JsonNumberValueResolve(num));
+        }
+
+        inline s64 JsonValue::GetInt64() const
+        {
+            const JsonNumberValue* num = AsNumber();
+            ASSERT(num);
+            if (num->m_NumberType == kJsonNumber_s64)
+                return num->m_S64;
+            return JsonNumberAsInt64(JsonNumberValueResolve(num));
+        }
+
+        inline u64 JsonValue::GetUInt64() const
+        {
+            const JsonNumberValue* num = AsNumber();
+            ASSERT(num);
+            if (num->m_NumberType == kJsonNumber_u64)
+                return num->m_U64;
+            return JsonNumberAsUInt64(JsonNumberValueResolve(num));
         }
 
         inline const char* JsonValue::GetString() const
@@ -172,11 +223,80 @@ namespace ncore
             return b->m_Boolean;
         }
 
+        enum EJsonParseFlags
+        {
+            kJsonParseDefault = 0x0,
+
+            // Strings (values and names) without escape sequences point directly into the input instead of being copied into 'allocator',
+            // they are NOT NUL terminated, use m_End / m_NameEnd. The input must outlive the document.
+            kJsonParseBorrowStrings = 0x1,
+
+            // Validate that strings (values and names) are well-formed UTF-8 (no overlong encodings, surrogates or truncated sequences).
+            kJsonParseValidateUtf8 = 0x2,
+
+            // Numbers are stored as their text, which points into the input, and converted on first access. Parsing skips the conversion
+            // of numbers that are never read, but the text is not checked until then. The input must outlive the document.
+            kJsonParseLazyNumbers = 0x4,
+
+            // Objects with kJsonObjectIndexMinMembers or more members get a hash index when they are closed, Find on them is O(1).
+            kJsonParseIndexObjects = 0x8,
+        };
+
+        struct JsonParseOptions
+        {
+            JsonParseOptions()
+                : m_Flags(kJsonParseDefault)
+                , m_MaxDepth(kJsonDefaultMaxDepth)
+                , m_KeyPool(nullptr)
+            {
+            }
+
+            u32             m_Flags;
+            s32             m_MaxDepth; // maximum nesting of arrays and objects, a deeper document is an error
+            JsonStringPool* m_KeyPool;  // member names are interned in this pool instead of 'allocator', names that do
+                                        // not fit in the pool are allocated as usual
+        };
+
         // Parse JSON text into a JsonValue document, when an error occurs the return value is nullptr and the error description is set in error_message
         // which is allocated from 'scratch'.
         // All necessary JSON values and their properties are allocated from 'allocator', you can thus free str/end as well as 'scratch' after calling
         // this function.
         const JsonValue* Parse(char const* str, char const* end, JsonAllocator* allocator, JsonAllocator* scratch, char const*& error_message);
+        const JsonValue* Parse(char const* str, char const* end, JsonAllocator* allocator, JsonAllocator* scratch, JsonParseOptions const& options, char const*& error_message);
+
+        // The memory that Parse needs for a document, with the same options and allocators that start out empty.
+        struct JsonParseSize
+        {
+            s64 m_AllocatorSize;   // capacity of 'allocator'
+            s64 m_ScratchSize;     // capacity of 'scratch'
+            s64 m_StringBytes;     // bytes of the strings (values and names) copied into 'allocator', terminators included
+            s32 m_NumberOfObjects;
+            s32 m_NumberOfArrays;
+            s32 m_NumberOfNumbers;
+            s32 m_NumberOfStrings; // string values, names are not included
+            s32 m_NumberOfNames;   // member names
+        };
+
+        // Measure what Parse needs for a document without building it, the parser itself runs and only counts what it
+        // would allocate so when this succeeds Parse will succeed with allocators of these sizes. Strings with escape
+        // sequences are unescaped into the free memory of 'scratch' while measuring, it needs room for the longest one
+        // on top of m_ScratchSize. Names
+        // are interned in m_KeyPool as Parse would. When an error occurs the return value is false and the error
+        // description is set in error_message, which is allocated from 'scratch'. Scratch memory that is used while
+        // measuring is given back.
+        bool Measure(char const* str, char const* end, JsonAllocator* scratch, JsonParseSize& size, char const*& error_message);
+        bool Measure(char const* str, char const* end, JsonAllocator* scratch, JsonParseOptions const& options, JsonParseSize& size, char const*& error_message);
+
+        // Measure and then parse, 'allocator' is initialized from 'alloc' with exactly the capacity the document
+        // needs, Destroy it to free the document. On an error, including a 'scratch' that has less free memory than
+        // the document needs, the return value is nullptr and 'allocator' is not initialized.
+        const JsonValue* ParseExact(char const* str, char const* end, alloc_t* alloc, JsonAllocator* allocator, JsonAllocator* scratch, JsonParseOptions const& options, char const*& error_message);
+
+        // Parse JSON text in-situ, all strings (values and names) are unescaped and NUL terminated in the input buffer, which is thus modified and
+        // must outlive the document. No string data is allocated from 'allocator', except member names interned in m_KeyPool.
+        // kJsonParseBorrowStrings does not apply, in-situ strings always point into the input.
+        const JsonValue* ParseInSitu(char* str, char* end, JsonAllocator* allocator, JsonAllocator* scratch, char const*& error_message);
+        const JsonValue* ParseInSitu(char* str, char* end, JsonAllocator* allocator, JsonAllocator* scratch, JsonParseOptions const& options, char const*& error_message);
 
     } // namespace njson
 } // namespace ncore
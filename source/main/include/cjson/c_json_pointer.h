@@ -0,0 +1,50 @@
+#ifndef __CJSON_JSON_POINTER_H__
+#define __CJSON_JSON_POINTER_H__
+#include "ccore/c_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include "ccore/c_debug.h"
+#include "cjson/c_json_allocator.h"
+#include "cjson/c_json_parser.h"
+#include "cjson/c_json_scanner.h"
+#include "cjson/c_json_tape.h"
+
+namespace ncore
+{
+    namespace njson
+    {
+        // A reference token of a JSON Pointer (RFC 6901), unescaped ("~1" is '/' and "~0" is '~')
+        struct JsonPointerStep
+        {
+            const char* m_Key;    // NUL terminated
+            s32         m_KeyLen;
+            u32         m_Hash;   // JsonHashName of the key
+            s32         m_Index;  // the key as an array index, -1 when it is not one (e.g. "-", "01" or "x")
+        };
+
+        // A compiled pointer, "" is the whole document and "/a/0" is element 0 of member "a" of the document
+        struct JsonPointer
+        {
+            const JsonPointerStep* m_Steps;
+            s32                    m_Count;
+        };
+
+        // Compile a pointer once, the steps and their keys are allocated from 'allocator', the text can be freed after
+        // the call. When the pointer is not valid the return value is nullptr and the error description is set in
+        // error_message, which is allocated from 'allocator'.
+        const JsonPointer* CompilePointer(char const* str, char const* end, JsonAllocator* allocator, char const*& error_message);
+        const JsonPointer* CompilePointer(char const* str, JsonAllocator* allocator, char const*& error_message);
+
+        // The value the pointer refers to, nullptr (or an invalid cursor) when there is none. Resolving a parsed or tape
+        // document does not allocate. A lazy scanner container on the path is expanded, its children are allocated from
+        // the allocator of the scan (see Expand), and one whose text is invalid (see IsError) resolves to nothing.
+        const JsonValue*           Resolve(JsonPointer const* pointer, JsonValue const* root);
+        const nscanner::JsonValue* Resolve(JsonPointer const* pointer, nscanner::JsonValue const* root);
+        JsonTapeValue              Resolve(JsonPointer const* pointer, JsonTapeValue root);
+
+    } // namespace njson
+} // namespace ncore
+
+#endif // __CJSON_JSON_POINTER_H__
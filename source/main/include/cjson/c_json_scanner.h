@@ -60,6 +60,43 @@ namespace ncore
                 JsonLinkedNamedValue* m_LinkedList;
             };
 
+            enum
+            {
+                kJsonLazyCount  = -1, // m_Count of an array or object that is not expanded yet
+                kJsonErrorCount = -2, // m_Count of an array or object whose text was found to be invalid when it was expanded
+            };
+
+            struct JsonValue;
+
+            // Shared by the lazy containers of a document
+            struct JsonLazyDocument
+            {
+                const char*      m_Text;      // errors found when a container is expanded are reported at their position in this text
+                JsonAllocator*   m_Allocator; // the children are allocated from this when a container is expanded
+                const JsonValue* m_NullValue;
+            };
+
+            // The text of an array or object that is not expanded yet, from its opening bracket up to and including
+            // its closing bracket
+            struct JsonLazySpan
+            {
+                const char*             m_Begin;
+                const char*             m_End;
+                const JsonLazyDocument* m_Document;
+            };
+
+            struct JsonLazyValue
+            {
+                i32                 m_Count; // kJsonLazyCount
+                const JsonLazySpan* m_Span;
+            };
+
+            struct JsonErrorValue
+            {
+                i32         m_Count; // kJsonErrorCount
+                const char* m_ErrorMessage;
+            };
+
             struct JsonValue
             {
                 enum Type
@@ -79,6 +116,8 @@ namespace ncore
                     JsonStringValue m_String;
                     JsonArrayValue  m_Array;
                     JsonObjectValue m_Object;
+                    JsonLazyValue   m_Lazy;
+                    JsonErrorValue  m_Error;
                 };
                 value_t m_Value;
 
@@ -88,6 +127,17 @@ namespace ncore
                 inline bool IsNumber() const { return m_Type == kNumber; }
                 inline bool IsBoolean() const { return m_Type == kBoolean; }
                 inline bool IsNull() const { return m_Type == kNull; }
+                inline bool IsLazy() const { return (m_Type == kArray || m_Type == kObject) && m_Value.m_Lazy.m_Count == kJsonLazyCount; }
+                inline bool IsError() const { return (m_Type == kArray || m_Type == kObject) && m_Value.m_Error.m_Count == kJsonErrorCount; }
+
+                // Expand an array or object that is not expanded yet, its children are scanned and its nested arrays
+                // and objects are again lazy. Returns the error description when the text of the container is not
+                // valid, the container is then marked with kJsonErrorCount (see IsError) and every later call returns
+                // the same description. ArrayHead, MemberHead and Find expand the container when needed, for a container
+                // in error they return nothing and a count of 0.
+                // The document is const but Expand writes to it, it is not thread-safe: expand the containers up front
+                // or guard the document when it is shared between threads.
+                const char* Expand() const;
 
                 const struct JsonObjectValue* AsObject() const;
                 const struct JsonNumberValue* AsNumber() const;
@@ -96,6 +146,8 @@ namespace ncore
 
                 const JsonLinkedValue*      ArrayHead(i32& count) const;
                 const JsonLinkedNamedValue* MemberHead(i32& count) const;
+                const JsonValue*            Find(const char* key) const; // the last member with this name
+                const JsonValue*            Find(const char* key, s32 len) const;
             };
 
             inline const JsonObjectValue* JsonValue::AsObject() const
@@ -130,6 +182,13 @@ namespace ncore
             {
                 const JsonArrayValue* array = AsArray();
                 ASSERT(array);
+                if (array->m_Count == kJsonLazyCount)
+                    Expand();
+                if (array->m_Count == kJsonErrorCount)
+                {
+                    count = 0;
+                    return nullptr;
+                }
                 count = array->m_Count;
                 return array->m_LinkedList;
             }
@@ -138,6 +197,13 @@ namespace ncore
             {
                 const JsonObjectValue* object = AsObject();
                 ASSERT(object);
+                if (object->m_Count == kJsonLazyCount)
+                    Expand();
+                if (object->m_Count == kJsonErrorCount)
+                {
+                    count = 0;
+                    return nullptr;
+                }
                 count = object->m_Count;
                 return object->m_LinkedList;
             }
@@ -145,7 +211,15 @@ namespace ncore
             // Scan JSON text into a lightweight JsonValue structure, there are no conversions happening, just determining [type, start-end] of objects, arrays, strings,
             // numbers, booleans and nulls.
             // All necessary JSON objects and their properties are allocated from 'allocator', you cannott free str/end, since all JSON objects reference the original text.
+            // Arrays and objects may be nested up to 'max_depth' levels (default 512), a deeper document is an error.
             const JsonValue* Scan(char const* str, char const* end, JsonAllocator* allocator, char const*& error_message);
+            const JsonValue* Scan(char const* str, char const* end, JsonAllocator* allocator, s32 max_depth, char const*& error_message);
+
+            // Scan lazily, arrays and objects are only recorded as the span of their text and their children are scanned
+            // when they are first accessed. An untouched container costs a skip over its structural characters, its
+            // content is not checked until it is expanded. Nesting is not limited, there are no frames for skipped
+            // containers. 'allocator' must outlive the document, expanding a container allocates from it.
+            const JsonValue* ScanLazy(char const* str, char const* end, JsonAllocator* allocator, char const*& error_message);
 
         } // namespace nscanner
     } // namespace njson
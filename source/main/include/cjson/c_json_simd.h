@@ -0,0 +1,84 @@
+#ifndef __CJSON_JSON_SIMD_H__
+#define __CJSON_JSON_SIMD_H__
+#include "ccore/c_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+// Instruction set selection for the byte classification kernels, the widest set that the compiler
+// is allowed to emit is used. Every kernel also has a scalar implementation that gives identical
+// results, define CJSON_NO_SIMD to force the scalar path.
+#if !defined(CJSON_NO_SIMD)
+#    if defined(__AVX2__)
+#        define CJSON_SIMD_AVX2
+#        define CJSON_SIMD_SSSE3
+#        define CJSON_SIMD_SSE2
+#        include <immintrin.h>
+#    elif defined(__SSSE3__)
+#        define CJSON_SIMD_SSSE3
+#        define CJSON_SIMD_SSE2
+#        include <tmmintrin.h>
+#    elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#        define CJSON_SIMD_SSE2
+#        include <emmintrin.h>
+#    endif
+#endif
+
+#if defined(_MSC_VER)
+#    include <intrin.h>
+#endif
+
+namespace ncore
+{
+    namespace njson
+    {
+        // Index of the lowest set bit, 'bits' must not be 0
+        inline s32 JsonCountTrailingZeros64(u64 bits)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward64(&index, bits);
+            return (s32)index;
+#else
+            return (s32)__builtin_ctzll(bits);
+#endif
+        }
+
+        // Number of zero bits above the highest set bit, 'bits' must not be 0
+        inline s32 JsonCountLeadingZeros64(u64 bits)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanReverse64(&index, bits);
+            return 63 - (s32)index;
+#else
+            return (s32)__builtin_clzll(bits);
+#endif
+        }
+
+        inline s32 JsonPopCount64(u64 bits)
+        {
+#if defined(_MSC_VER)
+            return (s32)__popcnt64(bits);
+#else
+            return (s32)__builtin_popcountll(bits);
+#endif
+        }
+
+        // Bit i of the result is the XOR of bits [0, i] of 'bits', this turns a mask of quotes into a
+        // mask of 'inside string' bits.
+        inline u64 JsonPrefixXor64(u64 bits)
+        {
+            bits ^= bits << 1;
+            bits ^= bits << 2;
+            bits ^= bits << 4;
+            bits ^= bits << 8;
+            bits ^= bits << 16;
+            bits ^= bits << 32;
+            return bits;
+        }
+
+    } // namespace njson
+} // namespace ncore
+
+#endif // __CJSON_JSON_SIMD_H__
@@ -0,0 +1,49 @@
+#ifndef __CJSON_JSON_STRING_POOL_H__
+#define __CJSON_JSON_STRING_POOL_H__
+#include "ccore/c_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include "cbase/c_allocator.h"
+#include "ccore/c_debug.h"
+#include "cjson/c_json_allocator.h"
+
+namespace ncore
+{
+    namespace njson
+    {
+        // A set of unique strings that outlives the documents that use it, a string that is interned twice is
+        // stored once and returned as the same pointer, interned strings can thus be compared by pointer.
+        // The table is open addressing over [hash 32-bit, string offset 32-bit] pairs, the strings are stored
+        // in their own allocator as a u32 length followed by the string and a terminating NUL.
+        // A pool can be pre-warmed with known strings before parsing and reused between documents.
+        struct JsonStringPool
+        {
+            void Init(alloc_t* alloc, s32 max_strings, s64 max_bytes, const char* debug_name);
+            void Destroy();
+            void Reset(); // removes all strings
+
+            // The pooled copy of the string, nullptr when the pool is full
+            const char* Intern(const char* str, const char* end);
+            const char* Intern(const char* str, const char* end, u32 hash); // hash is JsonHashName(str, end)
+
+            // The pooled copy of the string, nullptr when it is not in the pool
+            const char* Find(const char* str, const char* end) const;
+
+            static inline s32 Length(const char* pooled) { return (s32)*(u32 const*)(pooled - sizeof(u32)); }
+
+            DCORE_CLASS_PLACEMENT_NEW_DELETE
+
+            alloc_t*      m_Alloc;    // underlying allocator
+            u64*          m_Slots;    // [hash, offset] pairs, 0 is an empty slot
+            u32           m_Mask;     // number of slots - 1
+            s32           m_Count;    // number of strings
+            s32           m_MaxCount; // at most half of the slots are used
+            JsonAllocator m_Strings;  // the strings, m_Strings.m_Pointer + offset is a pooled string
+        };
+
+    } // namespace njson
+} // namespace ncore
+
+#endif // __CJSON_JSON_STRING_POOL_H__
@@ -0,0 +1,58 @@
+#ifndef __CJSON_JSON_STRUCTURAL_H__
+#define __CJSON_JSON_STRUCTURAL_H__
+#include "ccore/c_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+namespace ncore
+{
+    namespace njson
+    {
+        // Stage-1 of a JSON front end: classify the input in blocks of 64 bytes and find the offsets of
+        // all structural characters ({ } [ ] , :), the opening quote of every string and the first byte
+        // of every number or literal. Structural characters inside strings are not reported, a front end
+        // can thus walk the offsets instead of lexing byte by byte.
+
+        // Classification of a 64-byte block, bit i corresponds with byte i of the block
+        struct JsonBlockClass
+        {
+            u64 m_Quote;      // '"'
+            u64 m_Backslash;  // '\'
+            u64 m_Operator;   // { } [ ] , :
+            u64 m_Whitespace; // ' ', '\t', '\n', '\r'
+        };
+
+        void JsonClassifyBlock(const char* block, JsonBlockClass& out_class);       // Uses SIMD when available
+        void JsonClassifyBlockScalar(const char* block, JsonBlockClass& out_class); // Reference implementation
+
+        struct JsonStructuralState
+        {
+            const char* m_Begin;        // start of the document, offsets are relative to this
+            const char* m_Cursor;       // start of the next block to classify
+            const char* m_End;          // end of the document
+            u64         m_PrevEscaped;  // carry: first byte of the next block is escaped
+            u64         m_PrevInString; // carry: all ones when the previous block ended inside a string
+            u64         m_PrevScalar;   // carry: the previous block ended with a number or literal byte
+        };
+
+        void JsonStructuralInit(JsonStructuralState* state, char const* str, char const* end);
+
+        // Classify the next block and write the offsets of the structurals it contains to 'out_offsets',
+        // which must have room for 64 entries. Returns the number of offsets written, this can be 0 for
+        // a block that is fully inside a string, use JsonStructuralDone to detect the end of the input.
+        s32 JsonStructuralNextBlock(JsonStructuralState* state, u32* out_offsets);
+
+        inline bool JsonStructuralDone(JsonStructuralState const* state) { return state->m_Cursor >= state->m_End; }
+
+        // After the last block, true if the document ended inside a string
+        inline bool JsonStructuralInString(JsonStructuralState const* state) { return state->m_PrevInString != 0; }
+
+        // Build the structural index of a whole document, returns the number of offsets written or -1
+        // when 'out_offsets' (capacity of 'max_offsets') is too small.
+        s32 JsonStructuralIndex(char const* str, char const* end, u32* out_offsets, s32 max_offsets);
+
+    } // namespace njson
+} // namespace ncore
+
+#endif // __CJSON_JSON_STRUCTURAL_H__
@@ -0,0 +1,110 @@
+#ifndef __CJSON_JSON_TAPE_H__
+#define __CJSON_JSON_TAPE_H__
+#include "ccore/c_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include "ccore/c_debug.h"
+#include "cjson/c_json_allocator.h"
+#include "cjson/c_json_parser.h"
+
+namespace ncore
+{
+    namespace njson
+    {
+        // A document as a flat array of 64-bit words in document order, the type of a word is its top 8 bits
+        // and the other 56 bits are its payload:
+        // - '{' '[' : index of the matching end word in bits 0-31, the number of members or elements in bits
+        //             32-55 (saturated at kJsonTapeCountMax)
+        // - '}' ']' : index of the matching start word
+        // - '"'     : offset in the string buffer of the u32 length, followed by the string and a terminating NUL
+        // - 'l' 'u' 'd' : s64, u64 or f64, the value is the next word
+        // - 't' 'f' 'n' : true, false, null
+        // An object is its start word, then the name (a '"' word) and value of each member, then its end word.
+        enum EJsonTapeType
+        {
+            kJsonTapeObject    = '{',
+            kJsonTapeObjectEnd = '}',
+            kJsonTapeArray     = '[',
+            kJsonTapeArrayEnd  = ']',
+            kJsonTapeString    = '"',
+            kJsonTapeInt64     = 'l',
+            kJsonTapeUInt64    = 'u',
+            kJsonTapeFloat64   = 'd',
+            kJsonTapeTrue      = 't',
+            kJsonTapeFalse     = 'f',
+            kJsonTapeNull      = 'n',
+        };
+
+        enum
+        {
+            kJsonTapeCountMax = 0xFFFFFF,
+        };
+
+        struct JsonTapeValue;
+
+        struct JsonTape
+        {
+            u64 const*  m_Words;
+            s32         m_Count;   // number of words
+            char const* m_Strings; // string buffer, '"' words are offsets into it
+
+            JsonTapeValue Root() const;
+        };
+
+        // A cursor, the position of a value on the tape. It is two words, copy it freely.
+        struct JsonTapeValue
+        {
+            JsonTape const* m_Tape;
+            s32             m_Index;
+
+            inline u64  Word() const { return m_Tape->m_Words[m_Index]; }
+            inline u8   Type() const { return (u8)(Word() >> 56); }
+            inline bool IsValid() const { return m_Tape != nullptr && m_Index < m_Tape->m_Count && Type() != kJsonTapeObjectEnd && Type() != kJsonTapeArrayEnd; }
+            inline bool IsObject() const { return Type() == kJsonTapeObject; }
+            inline bool IsArray() const { return Type() == kJsonTapeArray; }
+            inline bool IsString() const { return Type() == kJsonTapeString; }
+            inline bool IsNumber() const { return Type() == kJsonTapeInt64 || Type() == kJsonTapeUInt64 || Type() == kJsonTapeFloat64; }
+            inline bool IsBoolean() const { return Type() == kJsonTapeTrue || Type() == kJsonTapeFalse; }
+            inline bool IsNull() const { return Type() == kJsonTapeNull; }
+
+            bool        GetBoolean() const;
+            f64         GetNumber() const;
+            s64         GetInt64() const;  // exact for integers, a f64 is truncated
+            u64         GetUInt64() const; // exact for integers, a f64 is truncated
+            const char* GetString() const; // NUL terminated
+            s32         GetStringLength() const;
+
+            // The value after this one, a container is skipped as a whole. At the end of an array or object
+            // the result is not valid.
+            JsonTapeValue Next() const;
+
+            // Arrays and objects
+            s32           Count() const;
+            JsonTapeValue First() const; // the first element, or the name of the first member of an object
+
+            JsonTapeValue At(s32 index) const;         // array element, linear in index
+            JsonTapeValue Find(const char* key) const; // object member value, the last member with this name
+            JsonTapeValue Find(const char* key, s32 len) const;
+        };
+
+        inline JsonTapeValue JsonTape::Root() const
+        {
+            JsonTapeValue v;
+            v.m_Tape  = this;
+            v.m_Index = 0;
+            return v;
+        }
+
+        // Parse JSON text into a tape, the JsonTape and its words are allocated from 'allocator' and the strings from
+        // 'strings', which must be two different allocators. On an error the return value is nullptr and the error
+        // description is set in error_message, which is allocated from 'scratch'. The input and 'scratch' can be freed
+        // after the call. Of the options only kJsonParseValidateUtf8 and m_MaxDepth apply.
+        const JsonTape* ParseTape(char const* str, char const* end, JsonAllocator* allocator, JsonAllocator* strings, JsonAllocator* scratch, char const*& error_message);
+        const JsonTape* ParseTape(char const* str, char const* end, JsonAllocator* allocator, JsonAllocator* strings, JsonAllocator* scratch, JsonParseOptions const& options, char const*& error_message);
+
+    } // namespace njson
+} // namespace ncore
+
+#endif // __CJSON_JSON_TAPE_H__
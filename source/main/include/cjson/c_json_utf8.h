@@ -0,0 +1,23 @@
+#ifndef __CJSON_JSON_UTF8_H__
+#define __CJSON_JSON_UTF8_H__
+#include "ccore/c_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+namespace ncore
+{
+    namespace njson
+    {
+        // UTF-8 validation according to the Unicode standard (Table 3-7), overlong encodings, surrogates
+        // (U+D800..U+DFFF), code points above U+10FFFF and truncated sequences are rejected. Runs of ASCII
+        // are skipped 16 bytes at a time, multi-byte text is validated with the nibble lookup-table method
+        // when SSSE3 is available.
+
+        bool        ValidateUtf8(char const* str, char const* end);
+        char const* FindInvalidUtf8(char const* str, char const* end); // first byte of the first invalid sequence, 'end' if valid
+
+    } // namespace njson
+} // namespace ncore
+
+#endif // __CJSON_JSON_UTF8_H__
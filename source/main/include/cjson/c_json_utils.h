@@ -35,6 +35,12 @@ namespace ncore
             };
         };
 
+        // Maximum nesting of arrays and objects unless configured otherwise, deeper documents are rejected with an error
+        enum
+        {
+            kJsonDefaultMaxDepth = 512,
+        };
+
         bool ParseBoolean(char const* str, char const* end);
         bool ParseHexNumber(char const*& str, char const* end, JsonNumber& out_number);
         bool ParseNumber(char const*& str, char const* end, JsonNumber& out_number);
@@ -45,6 +51,30 @@ namespace ncore
         u64         JsonNumberAsUInt64(JsonNumber const& number);
         f64         JsonNumberAsFloat64(JsonNumber const& number);
 
+        // 32-bit FNV-1a hash of a member name, used to index the members of an object
+        inline u32 JsonHashName(char const* str, char const* end)
+        {
+            u32 hash = 0x811C9DC5;
+            while (str < end)
+            {
+                hash ^= (u8)*str++;
+                hash *= 0x01000193;
+            }
+            return hash;
+        }
+
+        // Base 10 integer text, written two digits at a time after counting the digits. The text is truncated
+        // at end, it is not terminated, the return value is the end of the written text.
+        s32   JsonCountDigits(u64 value);
+        char* JsonFormatUInt64(u64 value, char* str, char const* end);
+        char* JsonFormatInt64(s64 value, char* str, char const* end);
+
+        // String content with '"', '\\' and control bytes escaped (\n, \t, .. or \u00XX), other bytes are copied as is.
+        // Writes as much of [str, str_end) as fits before end without splitting an escape sequence and advances
+        // str past what was written, so a caller can flush and continue. The text is not terminated, the return
+        // value is the end of the written text.
+        char* JsonEscapeString(char const*& str, char const* str_end, char* out, char const* end);
+
         // UTF-8; read a character and return the unicode codepoint (UTF-32)
         struct uchar8_t
         {
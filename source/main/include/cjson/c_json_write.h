@@ -0,0 +1,83 @@
+#ifndef __CJSON_JSON_WRITE_H__
+#define __CJSON_JSON_WRITE_H__
+#include "ccore/c_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include "ccore/c_debug.h"
+#include "cjson/c_json_parser.h"
+
+namespace ncore
+{
+    namespace njson
+    {
+        enum EJsonWriteFlags
+        {
+            // No whitespace at all: {"a":1,"b":[true,null]}
+            kJsonWriteCompact = 0x0,
+
+            // One member or element per line, indented by m_IndentSpaces per level, "name": value. Empty arrays
+            // and objects are written as [] and {}.
+            kJsonWritePretty = 0x1,
+        };
+
+        struct JsonWriteOptions
+        {
+            JsonWriteOptions()
+                : m_Flags(kJsonWriteCompact)
+                , m_IndentSpaces(2)
+                , m_MaxDepth(kJsonDefaultMaxDepth)
+                , m_Scratch(nullptr)
+            {
+            }
+
+            u32            m_Flags;
+            s32            m_IndentSpaces; // kJsonWritePretty only
+            s32            m_MaxDepth;     // maximum nesting of arrays and objects, a deeper document is not written
+            JsonAllocator* m_Scratch;      // m_MaxDepth frames of the walk are allocated from this and given back, without
+                                           // it the frames are on the stack and at most kJsonDefaultMaxDepth
+        };
+
+        // Receives the text of a document in chunks, return false to stop writing
+        typedef bool (*JsonWriteFlush)(void* user, char const* str, s32 len);
+
+        // The text is assembled in m_Buffer and handed to m_Flush whenever the buffer is full and once at the end,
+        // m_BufferSize must be at least kJsonWriteSinkMinSize.
+        struct JsonWriteSink
+        {
+            char*          m_Buffer;
+            s32            m_BufferSize;
+            JsonWriteFlush m_Flush;
+            void*          m_User;
+        };
+
+        enum
+        {
+            kJsonWriteSinkMinSize = 64,
+        };
+
+        // Strings are escaped, numbers are written with the same kernels as JsonEncode (shortest round-trip text for
+        // a f64, exact for integers) and a lazy number is converted first, see JsonNumberValueResolve. The document
+        // is walked with an explicit stack, see m_MaxDepth and m_Scratch. A document that cannot be written, a lazy
+        // number whose text is not a number, arrays and objects nested deeper than the stack or a scratch without room
+        // for the stack, is a write failure.
+
+        // Write 'value' as JSON text into [str, end) and terminate it, the return value points at the terminator.
+        // When the text does not fit or the document cannot be written, including a document nested deeper than the
+        // maximum depth, the return value is nullptr and the content of the buffer is undefined.
+        char* Write(JsonValue const* value, char* str, char const* end, JsonWriteOptions const& options);
+
+        // The exact length of the text that Write produces with these options, the terminator not included, so a
+        // buffer of WriteSize() + 1 bytes is enough. -1 when the document cannot be written, including a document
+        // nested deeper than the maximum depth.
+        s64 WriteSize(JsonValue const* value, JsonWriteOptions const& options);
+
+        // Write 'value' as JSON text to a sink, the text is not terminated. Returns false when m_Flush did or the
+        // document cannot be written.
+        bool Write(JsonValue const* value, JsonWriteSink const& sink, JsonWriteOptions const& options);
+
+    } // namespace njson
+} // namespace ncore
+
+#endif // __CJSON_JSON_WRITE_H__
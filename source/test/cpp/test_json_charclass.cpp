@@ -0,0 +1,53 @@
+#include "ccore/c_target.h"
+#include "cbase/c_runes.h"
+#include "cjson/c_json_charclass.h"
+
+#include "cunittest/cunittest.h"
+
+using namespace ncore;
+
+UNITTEST_SUITE_BEGIN(json_charclass)
+{
+    UNITTEST_FIXTURE(whitespace)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_TEST(classes)
+        {
+            CHECK_TRUE(njson::JsonIsWhitespace(' '));
+            CHECK_TRUE(njson::JsonIsWhitespace('\t'));
+            CHECK_TRUE(njson::JsonIsWhitespace('\n'));
+            CHECK_TRUE(njson::JsonIsWhitespace('\r'));
+            CHECK_TRUE(!njson::JsonIsWhitespace('\0'));
+            CHECK_TRUE(!njson::JsonIsWhitespace('\v'));
+            CHECK_TRUE(!njson::JsonIsWhitespace((char)0xA0));
+            CHECK_TRUE(njson::JsonIsOperator('{'));
+            CHECK_TRUE(njson::JsonIsOperator(':'));
+            CHECK_TRUE(!njson::JsonIsOperator('"'));
+            CHECK_TRUE(njson::JsonIsDigit('7'));
+            CHECK_TRUE(!njson::JsonIsDigit('-'));
+        }
+
+        UNITTEST_TEST(position)
+        {
+            const char* json = "{\n  \"a\": 1,\n\n  \"b\": [\n    1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16\n  ],\n  \"c\": x\n}";
+            const char* end  = json + ascii::strlen(json);
+            CHECK_EQUAL(7, njson::JsonCountNewlines(json, end));
+            CHECK_EQUAL(0, njson::JsonCountNewlines(json + 1, json + 1));
+
+            s32 line, column;
+            njson::JsonTextPosition(json, json, line, column);
+            CHECK_EQUAL(1, line);
+            CHECK_EQUAL(1, column);
+
+            const char* x = json;
+            while (*x != 'x')
+                ++x;
+            njson::JsonTextPosition(json, x, line, column);
+            CHECK_EQUAL(7, line);
+            CHECK_EQUAL(8, column);
+        }
+    }
+}
+UNITTEST_SUITE_END
@@ -13,6 +13,20 @@ using namespace ncore;
 extern unsigned char data_kyria[];
 extern unsigned int  data_kyria_len;
 
+static bool Contains(const char* text, const char* text_end, const char* find)
+{
+    s32 const n = ascii::strlen(find);
+    for (; (text + n) <= text_end; ++text)
+    {
+        s32 i = 0;
+        while (i < n && text[i] == find[i])
+            i++;
+        if (i == n)
+            return true;
+    }
+    return false;
+}
+
 struct key_t
 {
     key_t()
@@ -222,6 +236,160 @@ UNITTEST_SUITE_BEGIN(json_decode)
             char* json_text     = alloc.m_Pointer + alloc.m_Size;
             char* json_text_end = alloc.m_Pointer + alloc.m_Capacity;
             ok                  = njson::JsonEncode(json_root, json_text, json_text_end, error_message);
+            CHECK_TRUE(ok);
+
+            // Floats are written as the shortest text that reads back to the same value
+            char const* text_end = json_text + ascii::strlen(json_text);
+            CHECK_TRUE(Contains(json_text, text_end, "\"key_spacing_x\": 0.125,"));
+            CHECK_TRUE(Contains(json_text, text_end, "\"key_spacing_y\": 0.126,"));
+            CHECK_TRUE(Contains(json_text, text_end, "\"x\": 0.75,"));
+            CHECK_TRUE(Contains(json_text, text_end, "\"w\": -1.2,"));
+            // Signed integers
+            CHECK_TRUE(Contains(json_text, text_end, "\"c\": 2,"));
+            CHECK_TRUE(Contains(json_text, text_end, "\"index\": 12,"));
+
+            alloc.Destroy();
+            scratch.Destroy();
+        }
+
+        UNITTEST_TEST(max_depth)
+        {
+            keyboard_root_t root;
+
+            njson::JsonObject json_root;
+            json_root.m_descr    = &json_keyboards_root;
+            json_root.m_instance = &root;
+
+            njson::JsonAllocator alloc;
+            njson::JsonAllocator scratch;
+            alloc.Init(Allocator, 64 * 1024, "json allocator");
+            scratch.Init(Allocator, 64 * 1024, "json scratch allocator");
+
+            const char* json = "{ \"keyboard\": { \"keygroups\": [ { \"keys\": [ { \"w\": 1 } ] } ] } }";
+            const char* end  = json + ascii::strlen(json);
+
+            char const* error_message = nullptr;
+            bool        ok            = njson::JsonDecode(json, end, json_root, &alloc, &scratch, 6, error_message);
+            CHECK_TRUE(ok);
+
+            ok = njson::JsonDecode(json, end, json_root, &alloc, &scratch, 5, error_message);
+            CHECK_FALSE(ok);
+            CHECK_NOT_NULL(error_message);
+
+            // Unknown members are skipped without frames, their nesting does not count towards the depth
+            json = "{ \"unknown\": [ [ { \"a\": [ 1 ] } ] ] }";
+            end  = json + ascii::strlen(json);
+            ok   = njson::JsonDecode(json, end, json_root, &alloc, &scratch, 1, error_message);
+            CHECK_TRUE(ok);
+
+            alloc.Destroy();
+            scratch.Destroy();
+        }
+
+        UNITTEST_TEST(number_arrays)
+        {
+            keyboard_root_t root;
+
+            njson::JsonObject json_root;
+            json_root.m_descr    = &json_keyboards_root;
+            json_root.m_instance = &root;
+
+            njson::JsonAllocator alloc;
+            njson::JsonAllocator scratch;
+            alloc.Init(Allocator, 64 * 1024, "json allocator");
+            scratch.Init(Allocator, 64 * 1024, "json scratch allocator");
+
+            // A carray keeps the elements that fit, a vector is allocated with the element count
+            const char* json = "{ \"keyboard\": { \"cap_color\": [0.25, 0.5, 0.75, 1, 2], \"led_color\": [ ], \"keygroups\": [ { \"cap_color\": [ 1, -2.5e1,3 ], \"keys\": [ { \"led_color\": [0.5] } ] } ] } }";
+            const char* end  = json + ascii::strlen(json);
+
+            char const* error_message = nullptr;
+            bool        ok            = njson::JsonDecode(json, end, json_root, &alloc, &scratch, error_message);
+            CHECK_TRUE(ok);
+
+            keyboard_t const* keyboard = root.m_keyboard;
+            CHECK_EQUAL(0.25f, keyboard->m_capcolor[0]);
+            CHECK_EQUAL(0.5f, keyboard->m_capcolor[1]);
+            CHECK_EQUAL(0.75f, keyboard->m_capcolor[2]);
+            CHECK_EQUAL(1.0f, keyboard->m_capcolor[3]);
+            CHECK_EQUAL(1.0f, keyboard->m_ledcolor[2]);
+
+            CHECK_EQUAL(1, keyboard->m_nb_keygroups);
+            keygroup_t const& group = keyboard->m_keygroups[0];
+            CHECK_EQUAL(3, group.m_capcolor_size);
+            CHECK_EQUAL(1.0f, group.m_capcolor[0]);
+            CHECK_EQUAL(-25.0f, group.m_capcolor[1]);
+            CHECK_EQUAL(3.0f, group.m_capcolor[2]);
+
+            CHECK_EQUAL(1, group.m_nb_keys);
+            CHECK_EQUAL(1, group.m_keys[0].m_ledcolor_size);
+            CHECK_EQUAL(0.5f, group.m_keys[0].m_ledcolor[0]);
+
+            // A number array that is not well-formed is still an error
+            const char* bad = "{ \"keyboard\": { \"cap_color\": [1, 2 3] } }";
+            ok              = njson::JsonDecode(bad, bad + ascii::strlen(bad), json_root, &alloc, &scratch, error_message);
+            CHECK_FALSE(ok);
+
+            alloc.Destroy();
+            scratch.Destroy();
+        }
+
+        UNITTEST_TEST(unknown_members)
+        {
+            keyboard_root_t root;
+
+            njson::JsonObject json_root;
+            json_root.m_descr    = &json_keyboards_root;
+            json_root.m_instance = &root;
+
+            njson::JsonAllocator alloc;
+            njson::JsonAllocator scratch;
+            alloc.Init(Allocator, 64 * 1024, "json allocator");
+            scratch.Init(Allocator, 64 * 1024, "json scratch allocator");
+
+            const char* known = "{ \"keyboard\": { \"name\": \"K\", \"scale\": 3 } }";
+            char const* error_message = nullptr;
+            bool        ok            = njson::JsonDecode(known, known + ascii::strlen(known), json_root, &alloc, &scratch, error_message);
+            CHECK_TRUE(ok);
+            s64 const known_size = alloc.m_Size;
+
+            // The values of unknown members are skipped, nothing of them is allocated (up to alignment padding)
+            const char* json = "{ \"extra\": \"a\\\"]}\\n and some more text\", \"keyboard\": { \"junk\": [ { \"x\": \"]\" }, 1e400, [], \"\\u00e9\" ], "
+                               "\"name\": \"K\", \"more\": { \"y\": null, \"z\": [ true, false ] }, \"n\": 12.5, \"scale\": 3 }, \"tail\": true }";
+            alloc.Reset();
+            scratch.Reset();
+            ok = njson::JsonDecode(json, json + ascii::strlen(json), json_root, &alloc, &scratch, error_message);
+            CHECK_TRUE(ok);
+            CHECK_NULL(error_message);
+            CHECK_EQUAL("K", root.m_keyboard->m_name);
+            CHECK_EQUAL(3, root.m_keyboard->m_scale);
+            CHECK_EQUAL((known_size + 7) & ~7, (alloc.m_Size + 7) & ~7);
+
+            // An unknown array or object that is not closed is an error
+            const char* bad = "{ \"keyboard\": { \"junk\": [ { \"x\": 1 ] }";
+            ok              = njson::JsonDecode(bad, bad + ascii::strlen(bad), json_root, &alloc, &scratch, error_message);
+            CHECK_FALSE(ok);
+
+            // Names are not copied, a long unknown name fits an allocator that only has room for the known members
+            // and a name with escape sequences is still found
+            const char* head = "{ \"keyboard\": { \"";
+            const char* rest = "\": 1, \"n\\u0061me\": \"K\", \"scale\": 3 } }";
+            char*       text = scratch.AllocateArray<char>(4096);
+            char*       end  = text;
+            nmem::memcpy(end, head, ascii::strlen(head));
+            end += ascii::strlen(head);
+            nmem::memset(end, 'x', 2000);
+            end += 2000;
+            nmem::memcpy(end, rest, ascii::strlen(rest));
+            end += ascii::strlen(rest);
+
+            njson::JsonAllocator tight;
+            tight.Init(Allocator, known_size, "json allocator");
+            ok = njson::JsonDecode(text, end, json_root, &tight, &scratch, error_message);
+            CHECK_TRUE(ok);
+            CHECK_EQUAL("K", root.m_keyboard->m_name);
+            CHECK_EQUAL(3, root.m_keyboard->m_scale);
+            tight.Destroy();
 
             alloc.Destroy();
             scratch.Destroy();
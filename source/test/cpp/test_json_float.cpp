@@ -0,0 +1,284 @@
+#include "ccore/c_target.h"
+#include "cbase/c_runes.h"
+#include "cjson/c_json_utils.h"
+#include "cjson/c_json_float.h"
+
+#include "cunittest/cunittest.h"
+
+using namespace ncore;
+
+static njson::JsonNumber Parse(const char* str)
+{
+    njson::JsonNumber number;
+    njson::ParseNumber(str, str + ascii::strlen(str), number);
+    return number;
+}
+
+// The compiler converts the literal correctly rounded, the parsed text must give the identical bits
+static bool SameFloat(const char* str, f64 expected)
+{
+    njson::JsonNumber const number = Parse(str);
+    if (number.m_Type != njson::kJsonNumber_f64)
+        return false;
+    union
+    {
+        f64 m_F64;
+        u64 m_U64;
+    } a, b;
+    a.m_F64 = number.m_F64;
+    b.m_F64 = expected;
+    return a.m_U64 == b.m_U64;
+}
+
+#define CHECK_FLOAT(x) CHECK_TRUE(SameFloat(#x, x))
+
+static const char* Format64(f64 value)
+{
+    static char text[njson::kJsonFloatMaxChars + 1];
+    char* const end = njson::JsonFormatFloat64(value, text, text + njson::kJsonFloatMaxChars);
+    *end            = '\0';
+    return text;
+}
+
+static const char* Format32(f32 value)
+{
+    static char text[njson::kJsonFloatMaxChars + 1];
+    char* const end = njson::JsonFormatFloat32(value, text, text + njson::kJsonFloatMaxChars);
+    *end            = '\0';
+    return text;
+}
+
+// The formatted text parses back to the identical bits
+static bool RoundTrip64(u64 bits)
+{
+    union
+    {
+        f64 m_F64;
+        u64 m_U64;
+    } value;
+    value.m_U64 = bits;
+
+    char        text[njson::kJsonFloatMaxChars];
+    const char* str = text;
+    const char* end = njson::JsonFormatFloat64(value.m_F64, text, text + sizeof(text));
+    njson::JsonNumber number;
+    if (!njson::ParseNumber(str, end, number) || str != end)
+        return false;
+    f64 const parsed = (number.m_Type == njson::kJsonNumber_f64) ? number.m_F64 : (f64)number.m_S64;
+    value.m_F64      = parsed;
+    return value.m_U64 == bits;
+}
+
+UNITTEST_SUITE_BEGIN(json_float)
+{
+    UNITTEST_FIXTURE(parse)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_ALLOCATOR;
+
+        UNITTEST_TEST(fast_path)
+        {
+            CHECK_FLOAT(0.0);
+            CHECK_FLOAT(-0.0);
+            CHECK_FLOAT(1.5);
+            CHECK_FLOAT(-1.5e2);
+            CHECK_FLOAT(0.1);
+            CHECK_FLOAT(3.14159);
+            CHECK_FLOAT(1e22);
+            CHECK_FLOAT(123456.789e-3);
+        }
+
+        UNITTEST_TEST(eisel_lemire)
+        {
+            CHECK_FLOAT(1e23);
+            CHECK_FLOAT(1e308);
+            CHECK_FLOAT(1.7976931348623157e308);
+            CHECK_FLOAT(2.2250738585072014e-308);
+            CHECK_FLOAT(4.9406564584124654e-324);
+            CHECK_FLOAT(9007199254740993.0);
+            CHECK_FLOAT(7.3177701707893310e+15);
+            CHECK_FLOAT(-6.02214076e23);
+            CHECK_FLOAT(0.000000000000000000000000000000000000000000001e300);
+        }
+
+        UNITTEST_TEST(many_digits)
+        {
+            CHECK_FLOAT(0.1000000000000000055511151231257827021181583404541015625);
+            CHECK_FLOAT(3.14159265358979323846264338327950288419716939937510582097494459);
+            CHECK_FLOAT(2.2250738585072011e-308);
+            CHECK_FLOAT(2.22507385850720113605740979670913197593481954635164564e-308);
+            // Exactly halfway between 1 and the next float, ties to even
+            CHECK_FLOAT(1.00000000000000011102230246251565404236316680908203125);
+            CHECK_FLOAT(1.00000000000000011102230246251565404236316680908203125000000001);
+            CHECK_FLOAT(9007199254740992.99999999999999999999999999999999999999);
+        }
+
+        UNITTEST_TEST(integers)
+        {
+            njson::JsonNumber number = Parse("9223372036854775807");
+            CHECK_EQUAL(njson::kJsonNumber_s64, number.m_Type);
+            CHECK_EQUAL(9223372036854775807ll, number.m_S64);
+
+            number = Parse("18446744073709551615");
+            CHECK_EQUAL(njson::kJsonNumber_u64, number.m_Type);
+            CHECK_EQUAL(18446744073709551615ull, number.m_U64);
+
+            number = Parse("-9223372036854775808");
+            CHECK_EQUAL(njson::kJsonNumber_s64, number.m_Type);
+            CHECK_TRUE(number.m_S64 == (-9223372036854775807ll - 1));
+
+            // Too large for 64 bits
+            CHECK_TRUE(SameFloat("18446744073709551616", 18446744073709551616.0));
+            CHECK_TRUE(SameFloat("-9223372036854775809", -9223372036854775809.0));
+        }
+
+        UNITTEST_TEST(digit_runs)
+        {
+            const char* values[] = {"7", "12345678", "123456789", "1234567890123456", "12345678901234567", "1234567890123456789"};
+            u64 const   expected[] = {7ull, 12345678ull, 123456789ull, 1234567890123456ull, 12345678901234567ull, 1234567890123456789ull};
+            for (s32 i = 0; i < (s32)(sizeof(values) / sizeof(values[0])); ++i)
+            {
+                njson::JsonNumber const number = Parse(values[i]);
+                CHECK_EQUAL(njson::kJsonNumber_s64, number.m_Type);
+                CHECK_TRUE(number.m_U64 == expected[i]);
+            }
+
+            // The number ends at the first character that cannot continue it, in the same pass
+            const char*       json = "9876543210123,";
+            const char*       str  = json;
+            njson::JsonNumber number;
+            CHECK_TRUE(njson::ParseNumber(str, json + ascii::strlen(json), number));
+            CHECK_TRUE(str == json + 13);
+            CHECK_TRUE(number.m_S64 == 9876543210123ll);
+
+            json = "12345678.12345678e-3]";
+            str  = json;
+            CHECK_TRUE(njson::ParseNumber(str, json + ascii::strlen(json), number));
+            CHECK_TRUE(*str == ']');
+            CHECK_TRUE(SameFloat("12345678.12345678e-3", 12345678.12345678e-3));
+
+            // Overflow is detected on every digit past the 16th
+            CHECK_TRUE(SameFloat("99999999999999999999", 99999999999999999999.0));
+            CHECK_TRUE(SameFloat("123456789012345678901234", 123456789012345678901234.0));
+        }
+
+        UNITTEST_TEST(overflow)
+        {
+            njson::JsonNumber number = Parse("1e309");
+            CHECK_EQUAL(njson::kJsonNumber_f64, number.m_Type);
+            CHECK_TRUE(number.m_F64 > 1.7976931348623157e308);
+
+            number = Parse("-1e99999999999");
+            CHECK_TRUE(number.m_F64 < -1.7976931348623157e308);
+
+            number = Parse("1e-99999999999");
+            CHECK_TRUE(number.m_F64 == 0.0);
+        }
+    }
+
+    UNITTEST_FIXTURE(format)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_ALLOCATOR;
+
+        UNITTEST_TEST(shortest64)
+        {
+            CHECK_EQUAL("0.125", Format64(0.125));
+            CHECK_EQUAL("0.1", Format64(0.1));
+            CHECK_EQUAL("0.3", Format64(0.3));
+            CHECK_EQUAL("1.0", Format64(1.0));
+            CHECK_EQUAL("-2.5", Format64(-2.5));
+            CHECK_EQUAL("0.0", Format64(0.0));
+            CHECK_EQUAL("-0.0", Format64(-0.0));
+            CHECK_EQUAL("123.456", Format64(123.456));
+            CHECK_EQUAL("0.000001234", Format64(0.000001234));
+            CHECK_EQUAL("1e-7", Format64(1e-7));
+            CHECK_EQUAL("100000000000000000000.0", Format64(1e20));
+            CHECK_EQUAL("1e21", Format64(1e21));
+            CHECK_EQUAL("1e23", Format64(1e23));
+            CHECK_EQUAL("9007199254740992.0", Format64(9007199254740992.0));
+            CHECK_EQUAL("5e-324", Format64(5e-324));
+            CHECK_EQUAL("2.2250738585072014e-308", Format64(2.2250738585072014e-308));
+            CHECK_EQUAL("1.7976931348623157e308", Format64(1.7976931348623157e308));
+            // A power of two has a closer lower neighbour
+            CHECK_EQUAL("5.960464477539063e-8", Format64(5.9604644775390625e-8));
+        }
+
+        UNITTEST_TEST(shortest32)
+        {
+            CHECK_EQUAL("0.125", Format32(0.125f));
+            CHECK_EQUAL("0.1", Format32(0.1f));
+            CHECK_EQUAL("0.3", Format32(0.3f));
+            CHECK_EQUAL("16777216.0", Format32(16777216.0f));
+            CHECK_EQUAL("3.4028235e38", Format32(3.4028235e38f));
+            CHECK_EQUAL("1e-45", Format32(1e-45f));
+            CHECK_EQUAL("1.1754944e-38", Format32(1.17549435e-38f));
+        }
+
+        UNITTEST_TEST(integers)
+        {
+            u64 value = 1;
+            for (s32 digits = 1; digits <= 19; ++digits)
+            {
+                CHECK_EQUAL(digits, njson::JsonCountDigits(value));
+                CHECK_EQUAL(digits, njson::JsonCountDigits(value * 10 - 1));
+                value = value * 10;
+            }
+            CHECK_EQUAL(20, njson::JsonCountDigits(value));
+            CHECK_EQUAL(1, njson::JsonCountDigits(0));
+            CHECK_EQUAL(20, njson::JsonCountDigits(18446744073709551615ull));
+
+            char        text[24];
+            char const* end = njson::JsonFormatInt64(0, text, text + sizeof(text));
+            CHECK_TRUE(end == text + 1 && text[0] == '0');
+
+            const char* values[] = {"7", "-42", "9876543210", "-9223372036854775808", "9223372036854775807", "18446744073709551615"};
+            for (s32 i = 0; i < (s32)(sizeof(values) / sizeof(values[0])); ++i)
+            {
+                njson::JsonNumber const number = Parse(values[i]);
+                if (number.m_Type == njson::kJsonNumber_u64)
+                    end = njson::JsonFormatUInt64(number.m_U64, text, text + sizeof(text));
+                else
+                    end = njson::JsonFormatInt64(number.m_S64, text, text + sizeof(text));
+                *(char*)end = '\0';
+                CHECK_EQUAL(values[i], (const char*)text);
+            }
+
+            // Truncated at the end of the buffer
+            end = njson::JsonFormatInt64(-12345, text, text + 3);
+            CHECK_TRUE(end == text + 3 && text[0] == '-' && text[1] == '1' && text[2] == '2');
+        }
+
+        UNITTEST_TEST(truncate)
+        {
+            char        text[4];
+            char* const end = njson::JsonFormatFloat64(3.14159, text, text + sizeof(text));
+            CHECK_TRUE(end == text + 4);
+            CHECK_TRUE(text[0] == '3' && text[1] == '.' && text[2] == '1' && text[3] == '4');
+        }
+
+        UNITTEST_TEST(round_trip)
+        {
+            u64 bits = 88172645463325252ull;
+            for (s32 i = 0; i < 10000; ++i)
+            {
+                bits ^= bits << 13;
+                bits ^= bits >> 7;
+                bits ^= bits << 17;
+                u64 value = bits;
+                if ((i & 3) == 0)
+                    value &= 0x800FFFFFFFFFFFFFull; // subnormals
+                if ((i & 7) == 1)
+                    value &= 0xFFF0000000000000ull; // powers of two
+                if (((value >> 52) & 0x7FF) == 0x7FF)
+                    continue;
+                CHECK_TRUE(RoundTrip64(value));
+            }
+        }
+    }
+}
+UNITTEST_SUITE_END
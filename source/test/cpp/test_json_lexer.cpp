@@ -0,0 +1,152 @@
+#include "ccore/c_target.h"
+#include "cbase/c_memory.h"
+#include "cbase/c_runes.h"
+#include "cjson/c_json_lexer.h"
+#include "cjson/c_json_allocator.h"
+
+#include "cunittest/cunittest.h"
+
+using namespace ncore;
+
+typedef njson::JsonLexerPolicy<njson::JsonStringSpan, njson::JsonNumberRaw, njson::JsonUtf8Trust>        RawLexer;
+typedef njson::JsonLexerPolicy<njson::JsonStringCopy, njson::JsonNumberConvert, njson::JsonUtf8Trust>    CopyLexer;
+typedef njson::JsonLexerPolicy<njson::JsonStringCopy, njson::JsonNumberConvert, njson::JsonUtf8Validate> ValidateLexer;
+typedef njson::JsonLexerPolicy<njson::JsonStringBorrow, njson::JsonNumberConvert, njson::JsonUtf8Trust>  BorrowLexer;
+
+static bool StrEqual(njson::JsonLexeme const& l, const char* b)
+{
+    s32 const len = ascii::strlen(b);
+    return (s32)l.m_String.m_Len == len && nmem::memcmp(l.m_String.m_Str, b, len) == 0;
+}
+
+UNITTEST_SUITE_BEGIN(json_lexer)
+{
+    UNITTEST_FIXTURE(policies)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_ALLOCATOR;
+
+        UNITTEST_TEST(raw)
+        {
+            const char* json = "[ \"a\\tb\" , -12.5e3, true,null ]";
+
+            njson::JsonAllocator lsa;
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            njson::JsonLexerState lexer;
+            njson::JsonLexerStateInit(&lexer, json, json + ascii::strlen(json), &lsa, &lsa);
+
+            njson::JsonLexeme l;
+            CHECK_TRUE(njson::JsonLexerExpect<RawLexer>(&lexer, njson::kJsonLexBeginArray));
+            CHECK_TRUE(njson::JsonLexerExpect<RawLexer>(&lexer, njson::kJsonLexString, &l));
+            CHECK_TRUE(StrEqual(l, "a\\tb"));
+            CHECK_TRUE(njson::JsonLexerExpect<RawLexer>(&lexer, njson::kJsonLexValueSeparator));
+            CHECK_TRUE(njson::JsonLexerExpect<RawLexer>(&lexer, njson::kJsonLexNumber, &l));
+            CHECK_TRUE(StrEqual(l, "-12.5e3"));
+            CHECK_TRUE(njson::JsonLexerExpect<RawLexer>(&lexer, njson::kJsonLexValueSeparator));
+            CHECK_TRUE(njson::JsonLexerExpect<RawLexer>(&lexer, njson::kJsonLexBoolean, &l));
+            CHECK_TRUE(StrEqual(l, "true"));
+            CHECK_TRUE(njson::JsonLexerExpect<RawLexer>(&lexer, njson::kJsonLexValueSeparator));
+            CHECK_TRUE(njson::JsonLexerExpect<RawLexer>(&lexer, njson::kJsonLexNull));
+            CHECK_TRUE(njson::JsonLexerExpect<RawLexer>(&lexer, njson::kJsonLexEndArray));
+            CHECK_TRUE(njson::JsonLexerExpect<RawLexer>(&lexer, njson::kJsonLexEof));
+            CHECK_TRUE(njson::JsonLexerExpect<RawLexer>(&lexer, njson::kJsonLexEof));
+
+            lsa.Destroy();
+        }
+
+        UNITTEST_TEST(convert)
+        {
+            const char* json = "{\"k\\u0061y\": [42, false]}";
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 8192, "json_main");
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            njson::JsonLexerState lexer;
+            njson::JsonLexerStateInit(&lexer, json, json + ascii::strlen(json), &lma, &lsa);
+
+            njson::JsonLexeme l;
+            CHECK_TRUE(njson::JsonLexerExpect<CopyLexer>(&lexer, njson::kJsonLexBeginObject));
+            CHECK_TRUE(njson::JsonLexerExpect<CopyLexer>(&lexer, njson::kJsonLexString, &l));
+            CHECK_TRUE(StrEqual(l, "kay"));
+            CHECK_EQUAL(0, l.m_String.m_Str[l.m_String.m_Len]);
+            CHECK_TRUE(njson::JsonLexerExpect<CopyLexer>(&lexer, njson::kJsonLexNameSeparator));
+            CHECK_TRUE(njson::JsonLexerExpect<CopyLexer>(&lexer, njson::kJsonLexBeginArray));
+            CHECK_TRUE(njson::JsonLexerExpect<CopyLexer>(&lexer, njson::kJsonLexNumber, &l));
+            CHECK_EQUAL(42, njson::JsonNumberAsInt64(l.m_Number));
+            CHECK_TRUE(njson::JsonLexerExpect<CopyLexer>(&lexer, njson::kJsonLexValueSeparator));
+            CHECK_TRUE(njson::JsonLexerExpect<CopyLexer>(&lexer, njson::kJsonLexBoolean, &l));
+            CHECK_EQUAL(0, l.m_Number.m_S64);
+            CHECK_TRUE(njson::JsonLexerPeek<CopyLexer>(&lexer).m_Type == njson::kJsonLexEndArray);
+            njson::JsonLexerSkip<CopyLexer>(&lexer);
+            CHECK_TRUE(njson::JsonLexerExpect<CopyLexer>(&lexer, njson::kJsonLexEndObject));
+            CHECK_TRUE(njson::JsonLexerExpect<CopyLexer>(&lexer, njson::kJsonLexEof));
+
+            lsa.Destroy();
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(borrow)
+        {
+            const char* json = "[\"plain\", \"esc\\naped\"]";
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 8192, "json_main");
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            njson::JsonLexerState lexer;
+            njson::JsonLexerStateInit(&lexer, json, json + ascii::strlen(json), &lma, &lsa);
+
+            njson::JsonLexeme l;
+            CHECK_TRUE(njson::JsonLexerExpect<BorrowLexer>(&lexer, njson::kJsonLexBeginArray));
+            CHECK_TRUE(njson::JsonLexerExpect<BorrowLexer>(&lexer, njson::kJsonLexString, &l));
+            CHECK_TRUE(l.m_String.m_Str == json + 2);
+            CHECK_TRUE(StrEqual(l, "plain"));
+            CHECK_TRUE(njson::JsonLexerExpect<BorrowLexer>(&lexer, njson::kJsonLexValueSeparator));
+            CHECK_TRUE(njson::JsonLexerExpect<BorrowLexer>(&lexer, njson::kJsonLexString, &l));
+            CHECK_TRUE(StrEqual(l, "esc\naped"));
+
+            lsa.Destroy();
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(errors)
+        {
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 8192, "json_main");
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            const char*           illegal_number = "[12abc]";
+            njson::JsonLexerState lexer;
+            njson::JsonLexerStateInit(&lexer, illegal_number, illegal_number + ascii::strlen(illegal_number), &lma, &lsa);
+            njson::JsonLexerSkip<CopyLexer>(&lexer);
+            CHECK_TRUE(njson::JsonLexerNext<CopyLexer>(&lexer).m_Type == njson::kJsonLexError);
+            CHECK_TRUE(lexer.m_ErrorMessage != nullptr);
+
+            const char* bad_escape = "\"\\x\"";
+            njson::JsonLexerStateInit(&lexer, bad_escape, bad_escape + ascii::strlen(bad_escape), &lma, &lsa);
+            CHECK_TRUE(njson::JsonLexerNext<CopyLexer>(&lexer).m_Type == njson::kJsonLexError);
+
+            const char* bad_literal = "nul";
+            njson::JsonLexerStateInit(&lexer, bad_literal, bad_literal + ascii::strlen(bad_literal), &lma, &lsa);
+            CHECK_TRUE(njson::JsonLexerNext<RawLexer>(&lexer).m_Type == njson::kJsonLexError);
+
+            // Invalid UTF-8 is only reported by the validating lexer
+            const char* bad_utf8 = "\"\xc3\x28\"";
+            njson::JsonLexerStateInit(&lexer, bad_utf8, bad_utf8 + ascii::strlen(bad_utf8), &lma, &lsa);
+            CHECK_TRUE(njson::JsonLexerNext<CopyLexer>(&lexer).m_Type == njson::kJsonLexString);
+            njson::JsonLexerStateInit(&lexer, bad_utf8, bad_utf8 + ascii::strlen(bad_utf8), &lma, &lsa);
+            CHECK_TRUE(njson::JsonLexerNext<ValidateLexer>(&lexer).m_Type == njson::kJsonLexError);
+
+            lsa.Destroy();
+            lma.Destroy();
+        }
+    }
+}
+UNITTEST_SUITE_END
@@ -1,4 +1,5 @@
 #include "ccore/c_target.h"
+#include "cbase/c_memory.h"
 #include "cbase/c_runes.h"
 #include "cjson/c_json_parser.h"
 #include "cjson/c_json_allocator.h"
@@ -10,6 +11,18 @@ using namespace ncore;
 extern unsigned char data_kyria[];
 extern unsigned int  data_kyria_len;
 
+static bool StrEqual(const char* a, const char* b)
+{
+    s32 const len = ascii::strlen(b);
+    return ascii::strlen(a) == len && nmem::memcmp(a, b, len) == 0;
+}
+
+static bool StrEqual(njson::JsonValue const* value, const char* b)
+{
+    s32 const len = ascii::strlen(b);
+    return (s32)(value->m_Value.m_String.m_End - value->m_Value.m_String.m_String) == len && nmem::memcmp(value->m_Value.m_String.m_String, b, len) == 0;
+}
+
 UNITTEST_SUITE_BEGIN(json_parser)
 {
     UNITTEST_FIXTURE(parse)
@@ -37,6 +50,623 @@ UNITTEST_SUITE_BEGIN(json_parser)
             lsa.Destroy();
             lma.Destroy();
         }
+
+        UNITTEST_TEST(strings)
+        {
+            const char* json = "{ \"plain\": \"the quick brown fox jumps over the lazy dog\","
+                               "  \"escaped\": \"tab\\there, quote\\\" and backslash\\\\ with \\u00e9 after a long run of plain text\","
+                               "  \"utf8\": \"h\xc3\xa9llo w\xc3\xb6rld, this line is longer than a single vector\","
+                               "  \"empty\": \"\" }";
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 16384, "json_main");
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            const char*             errmsg;
+            njson::JsonValue const* root = njson::Parse(json, json + ascii::strlen(json), &lma, &lsa, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_TRUE(StrEqual(root->Find("plain")->GetString(), "the quick brown fox jumps over the lazy dog"));
+            CHECK_TRUE(StrEqual(root->Find("escaped")->GetString(), "tab\there, quote\" and backslash\\ with \xc3\xa9 after a long run of plain text"));
+            CHECK_TRUE(StrEqual(root->Find("utf8")->GetString(), "h\xc3\xa9llo w\xc3\xb6rld, this line is longer than a single vector"));
+
+            // An unterminated string is an error, not a read past the end
+            const char* bad = "[\"no closing quote, but plenty of characters to scan";
+            root            = njson::Parse(bad, bad + ascii::strlen(bad), &lma, &lsa, errmsg);
+            CHECK_NULL(root);
+            CHECK_TRUE(errmsg != nullptr);
+
+            lsa.Destroy();
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(borrow_strings)
+        {
+            const char* json = "{ \"name\": \"borrowed\", \"esc\\u0061ped\": \"line\\nbreak\" }";
+            const char* end  = json + ascii::strlen(json);
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 16384, "json_main");
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            njson::JsonParseOptions options;
+            options.m_Flags = njson::kJsonParseBorrowStrings;
+
+            const char*             errmsg;
+            njson::JsonValue const* root = njson::Parse(json, end, &lma, &lsa, options, errmsg);
+            CHECK_NULL(errmsg);
+
+            njson::JsonValue const* name = root->Find("name");
+            CHECK_TRUE(name != nullptr);
+            CHECK_TRUE(name->m_Value.m_String.m_String > json && name->m_Value.m_String.m_End < end);
+            CHECK_TRUE(StrEqual(name, "borrowed"));
+
+            // Escaped strings are still unescaped into the allocator
+            njson::JsonValue const* escaped = root->Find("escaped");
+            CHECK_TRUE(escaped != nullptr);
+            CHECK_TRUE(escaped->m_Value.m_String.m_String < json || escaped->m_Value.m_String.m_String >= end);
+            CHECK_TRUE(StrEqual(escaped, "line\nbreak"));
+
+            lsa.Destroy();
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(borrow_strings_uses_less_memory)
+        {
+            const char* json     = (const char*)data_kyria;
+            const char* json_end = json + data_kyria_len;
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 16384, "json_main");
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            const char*             errmsg;
+            njson::JsonValue const* root = njson::Parse(json, json_end, &lma, &lsa, errmsg);
+            CHECK_NULL(errmsg);
+            s64 const copied_size = lma.m_Size;
+
+            lma.Reset();
+            lsa.Reset();
+
+            njson::JsonParseOptions options;
+            options.m_Flags = njson::kJsonParseBorrowStrings;
+            root            = njson::Parse(json, json_end, &lma, &lsa, options, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_TRUE(root->m_Type == njson::JsonValue::kObject);
+            CHECK_TRUE(lma.m_Size < copied_size);
+
+            lsa.Destroy();
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(in_situ)
+        {
+            char      json[]   = "{ \"name\": \"in situ\", \"esc\\u0061ped\": \"tab\\tand \\\"quotes\\\"\", \"empty\": \"\", \"list\": [\"a\\/b\", 1, true] }";
+            s32 const json_len = ascii::strlen(json);
+            char*     end      = json + json_len;
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 16384, "json_main");
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            const char*             errmsg;
+            njson::JsonValue const* root = njson::ParseInSitu(json, end, &lma, &lsa, errmsg);
+            CHECK_NULL(errmsg);
+
+            njson::JsonValue const* name = root->Find("name");
+            CHECK_TRUE(name->GetString() > json && name->GetString() < end);
+            CHECK_TRUE(StrEqual(name->GetString(), "in situ"));
+
+            njson::JsonValue const* escaped = root->Find("escaped");
+            CHECK_TRUE(escaped->GetString() > json && escaped->GetString() < end);
+            CHECK_TRUE(StrEqual(escaped->GetString(), "tab\tand \"quotes\""));
+            CHECK_TRUE(StrEqual(escaped, "tab\tand \"quotes\""));
+
+            CHECK_TRUE(StrEqual(root->Find("empty")->GetString(), ""));
+
+            i32                            count = 0;
+            njson::JsonValue const* const* items = root->Find("list")->Elements(count);
+            CHECK_EQUAL(3, count);
+            CHECK_TRUE(StrEqual(items[0]->GetString(), "a/b"));
+
+            lsa.Destroy();
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(in_situ_options)
+        {
+            // Parsing in-situ modifies the text, every parse gets a fresh copy
+            const char* text     = "{ \"a\": [ [ 12345678901234567890 ] ], \"b\": \"x\" }";
+            s32 const   json_len = ascii::strlen(text);
+            char        json[64];
+            char*       end = json + json_len;
+            nmem::memcpy(json, text, json_len);
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 16384, "json_main");
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            njson::JsonParseOptions options;
+            options.m_Flags    = njson::kJsonParseLazyNumbers | njson::kJsonParseValidateUtf8;
+            options.m_MaxDepth = 3;
+
+            const char*             errmsg;
+            njson::JsonValue const* root = njson::ParseInSitu(json, end, &lma, &lsa, options, errmsg);
+            CHECK_NULL(errmsg);
+            njson::JsonValue const* number = root->Find("a")->At(0)->At(0);
+            CHECK_EQUAL(njson::kJsonNumber_unknown, (s32)number->AsNumber()->m_NumberType);
+            CHECK_EQUAL(12345678901234567890ull, number->GetUInt64());
+
+            CHECK_TRUE(StrEqual(root->Find("b")->GetString(), "x"));
+
+            nmem::memcpy(json, text, json_len);
+            options.m_MaxDepth = 2;
+            root               = njson::ParseInSitu(json, end, &lma, &lsa, options, errmsg);
+            CHECK_NULL(root);
+            CHECK_NOT_NULL(errmsg);
+
+            char bad[] = "[ \"\xC0\xAF\" ]";
+            options.m_MaxDepth = njson::kJsonDefaultMaxDepth;
+            root               = njson::ParseInSitu(bad, bad + ascii::strlen(bad), &lma, &lsa, options, errmsg);
+            CHECK_NULL(root);
+            CHECK_NOT_NULL(errmsg);
+
+            lsa.Destroy();
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(lexer_errors)
+        {
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 64 * 1024, "json_main");
+            lsa.Init(Allocator, 64 * 1024, "json_scratch");
+
+            njson::JsonParseOptions options;
+            options.m_Flags = njson::kJsonParseValidateUtf8;
+
+            // The message and position of the lexer are reported, not a generic parse error
+            const char* json[]     = {"[\"a\xC0\x80\"]", "[ \"a\\q\" ]", "{ \"k\": 12x }", "{ \"a\\q\": 1 }"};
+            const char* expected[] = {"line 1, column 2: invalid UTF-8 in string", "line 1, column 3: unexpected character in string", "line 1, column 8: illegal number",
+                                      "line 1, column 3: unexpected character in string"};
+            for (s32 i = 0; i < 4; ++i)
+            {
+                lsa.Reset();
+                const char*             errmsg = nullptr;
+                njson::JsonValue const* root   = njson::Parse(json[i], json[i] + ascii::strlen(json[i]), &lma, &lsa, options, errmsg);
+                CHECK_NULL(root);
+                CHECK_EQUAL(expected[i], errmsg);
+            }
+
+            lma.Destroy();
+            lsa.Destroy();
+        }
+
+        UNITTEST_TEST(max_depth)
+        {
+            const char* json = "{ \"a\": [ [ { \"b\": [ 1, 2 ] } ] ], \"c\": true }";
+            const char* end  = json + ascii::strlen(json);
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 256 * 1024, "json_main");
+            lsa.Init(Allocator, 64 * 1024, "json_scratch");
+
+            njson::JsonParseOptions options;
+            options.m_MaxDepth = 5;
+
+            const char*             errmsg;
+            njson::JsonValue const* root = njson::Parse(json, end, &lma, &lsa, options, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_TRUE(root->Find("c") != nullptr);
+
+            options.m_MaxDepth = 4;
+            root               = njson::Parse(json, end, &lma, &lsa, options, errmsg);
+            CHECK_NULL(root);
+            CHECK_NOT_NULL(errmsg);
+
+            // Far deeper than the default limit, must be an error and not a stack overflow
+            s32 const depth = 10000;
+            char*     deep  = lma.AllocateArray<char>(2 * depth);
+            for (s32 i = 0; i < depth; ++i)
+            {
+                deep[i]                 = '[';
+                deep[2 * depth - 1 - i] = ']';
+            }
+            root = njson::Parse(deep, deep + 2 * depth, &lma, &lsa, errmsg);
+            CHECK_NULL(root);
+            CHECK_NOT_NULL(errmsg);
+
+            lsa.Destroy();
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(exact_integers)
+        {
+            const char* json = "{ \"id\": 9007199254740993, \"min\": -9223372036854775808, \"max\": 18446744073709551615, \"f\": 2.5 }";
+            const char* end  = json + ascii::strlen(json);
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 16384, "json_main");
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            njson::JsonParseOptions options;
+            for (s32 lazy = 0; lazy < 2; ++lazy)
+            {
+                options.m_Flags = lazy ? njson::kJsonParseLazyNumbers : njson::kJsonParseDefault;
+
+                const char*             errmsg;
+                njson::JsonValue const* root = njson::Parse(json, end, &lma, &lsa, options, errmsg);
+                CHECK_NULL(errmsg);
+
+                njson::JsonValue const* id = root->Find("id");
+                if (lazy)
+                {
+                    CHECK_EQUAL(njson::kJsonNumber_unknown, id->m_Value.m_Number.m_NumberType);
+                    CHECK_TRUE(id->m_Value.m_Number.m_Text > json && id->m_Value.m_Number.m_Text < end);
+                }
+                CHECK_TRUE(id->GetInt64() == 9007199254740993ll);
+                CHECK_EQUAL(njson::kJsonNumber_s64, id->m_Value.m_Number.m_NumberType);
+                CHECK_TRUE(id->GetUInt64() == 9007199254740993ull);
+
+                CHECK_TRUE(root->Find("min")->GetInt64() == (-9223372036854775807ll - 1));
+                CHECK_TRUE(root->Find("max")->GetUInt64() == 18446744073709551615ull);
+                CHECK_EQUAL(2.5, root->Find("f")->GetNumber());
+                CHECK_EQUAL(2, root->Find("f")->GetInt64());
+            }
+
+            lsa.Destroy();
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(arrays)
+        {
+            const char* json = "{ \"empty\": [], \"matrix\": [ [ 1, 2, 3 ], [], [ 4, [ 5, 6 ] ] ], \"mixed\": [ true, null, \"s\", { \"k\": 7 } ] }";
+            const char* end  = json + ascii::strlen(json);
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 16384, "json_main");
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            const char*             errmsg;
+            njson::JsonValue const* root = njson::Parse(json, end, &lma, &lsa, errmsg);
+            CHECK_NULL(errmsg);
+
+            i32 count = -1;
+            root->Find("empty")->Elements(count);
+            CHECK_EQUAL(0, count);
+            CHECK_NULL(root->Find("empty")->At(0));
+
+            njson::JsonValue const*        matrix = root->Find("matrix");
+            njson::JsonValue const* const* rows   = matrix->Elements(count);
+            CHECK_EQUAL(3, count);
+            CHECK_EQUAL(3, rows[0]->m_Value.m_Array.m_Count);
+            CHECK_EQUAL(0, rows[1]->m_Value.m_Array.m_Count);
+            CHECK_EQUAL(3, matrix->At(0)->At(2)->GetInt64());
+            CHECK_EQUAL(6, matrix->At(2)->At(1)->At(1)->GetInt64());
+            CHECK_NULL(matrix->At(3));
+            CHECK_NULL(matrix->At(-1));
+
+            njson::JsonValue const* mixed = root->Find("mixed");
+            CHECK_TRUE(mixed->At(0)->GetBoolean());
+            CHECK_TRUE(mixed->At(1)->IsNull());
+            CHECK_TRUE(StrEqual(mixed->At(2)->GetString(), "s"));
+            CHECK_EQUAL(7, mixed->At(3)->Find("k")->GetInt64());
+
+            lsa.Destroy();
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(object_members)
+        {
+            const char* json = "{ \"z\": 1, \"a\": { }, \"m\": { \"y\": 2, \"x\": [ { \"w\": 3 } ] }, \"a\": 4 }";
+            const char* end  = json + ascii::strlen(json);
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 16384, "json_main");
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            const char*             errmsg;
+            njson::JsonValue const* root = njson::Parse(json, end, &lma, &lsa, errmsg);
+            CHECK_NULL(errmsg);
+
+            // Members are in document order and next to each other
+            njson::JsonObjectValue const* object = root->AsObject();
+            CHECK_EQUAL(4, object->m_Count);
+            const char* names[] = {"z", "a", "m", "a"};
+            for (s32 i = 0; i < 4; ++i)
+            {
+                CHECK_EQUAL(1, (s32)(object->m_Members[i].m_NameEnd - object->m_Members[i].m_Name));
+                CHECK_TRUE(object->m_Members[i].m_Name[0] == names[i][0]);
+            }
+            CHECK_EQUAL(0, object->m_Members[1].m_Value->AsObject()->m_Count);
+
+            njson::JsonObjectValue const* m = root->Find("m")->AsObject();
+            CHECK_EQUAL(2, m->m_Count);
+            CHECK_TRUE(m->m_Members[0].m_Name[0] == 'y');
+            CHECK_TRUE(m->m_Members[1].m_Name[0] == 'x');
+            CHECK_EQUAL(3, m->m_Members[1].m_Value->At(0)->Find("w")->GetInt64());
+
+            // A duplicate name finds the member that came last
+            CHECK_EQUAL(4, root->Find("a")->GetInt64());
+            CHECK_NULL(root->Find("b"));
+
+            lsa.Destroy();
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(indexed_objects)
+        {
+            // An object with more members than the index threshold, "k7" is a duplicate at the end
+            s32 const n = 500;
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            njson::JsonAllocator text;
+            lma.Init(Allocator, 256 * 1024, "json_main");
+            lsa.Init(Allocator, 64 * 1024, "json_scratch");
+            text.Init(Allocator, 32 * 1024, "json_text");
+
+            char* const json     = text.AllocateArray<char>(16 * n + 32);
+            char const* json_end = json + 16 * n + 32;
+            char*       end      = json;
+            *end++               = '{';
+            for (s32 i = 0; i <= n; ++i)
+            {
+                if (i > 0)
+                    *end++ = ',';
+                *end++ = '"';
+                *end++ = 'k';
+                end    = njson::JsonFormatInt64(i < n ? i : 7, end, json_end);
+                *end++ = '"';
+                *end++ = ':';
+                end    = njson::JsonFormatInt64(i, end, json_end);
+            }
+            *end++ = '}';
+
+            njson::JsonParseOptions options;
+            for (s32 indexed = 0; indexed < 2; ++indexed)
+            {
+                options.m_Flags = indexed ? njson::kJsonParseIndexObjects : njson::kJsonParseDefault;
+
+                const char*             errmsg;
+                njson::JsonValue const* root = njson::Parse(json, end, &lma, &lsa, options, errmsg);
+                CHECK_NULL(errmsg);
+                CHECK_EQUAL(n + 1, root->AsObject()->m_Count);
+                if (indexed)
+                    CHECK_TRUE(root->AsObject()->m_IndexMask >= (u32)(2 * n - 1));
+                else
+                    CHECK_EQUAL(0, (s32)root->AsObject()->m_IndexMask);
+
+                CHECK_EQUAL(0, root->Find("k0")->GetInt64());
+                CHECK_EQUAL(123, root->Find("k123")->GetInt64());
+                CHECK_EQUAL(n - 1, root->Find("k499")->GetInt64());
+                CHECK_EQUAL(n, root->Find("k7")->GetInt64());
+                CHECK_EQUAL(45, root->Find("k456", 3)->GetInt64());
+                CHECK_NULL(root->Find("k500"));
+                CHECK_NULL(root->Find("k"));
+                CHECK_NULL(root->Find(""));
+
+                // The member array is the same with or without an index
+                CHECK_EQUAL(n, root->AsObject()->m_Members[n].m_Value->GetInt64());
+                CHECK_EQUAL(4, (s32)(root->AsObject()->m_Members[123].m_NameEnd - root->AsObject()->m_Members[123].m_Name));
+            }
+
+            // Small objects are not indexed
+            const char*             small = "{ \"a\": 1, \"b\": 2 }";
+            const char*             errmsg;
+            njson::JsonValue const* root  = njson::Parse(small, small + ascii::strlen(small), &lma, &lsa, options, errmsg);
+            CHECK_EQUAL(0, (s32)root->AsObject()->m_IndexMask);
+            CHECK_EQUAL(2, root->Find("b")->GetInt64());
+
+            text.Destroy();
+            lsa.Destroy();
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(large_array)
+        {
+            s32 const n    = 10000;
+            char*     json = nullptr;
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            njson::JsonAllocator text;
+            lma.Init(Allocator, 1024 * 1024, "json_main");
+            lsa.Init(Allocator, 512 * 1024, "json_scratch");
+            text.Init(Allocator, 128 * 1024, "json_text");
+
+            json      = text.AllocateArray<char>(8 * n);
+            char* end = json;
+            *end++    = '[';
+            for (s32 i = 0; i < n; ++i)
+            {
+                if (i > 0)
+                    *end++ = ',';
+                end = njson::JsonFormatInt64(i, end, json + 8 * n);
+            }
+            *end++ = ']';
+
+            const char*             errmsg;
+            njson::JsonValue const* root = njson::Parse(json, end, &lma, &lsa, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_EQUAL(n, root->m_Value.m_Array.m_Count);
+            CHECK_EQUAL(0, root->At(0)->GetInt64());
+            CHECK_EQUAL(4321, root->At(4321)->GetInt64());
+            CHECK_EQUAL(n - 1, root->At(n - 1)->GetInt64());
+
+            // The elements were collected in scratch and released when the array closed
+            CHECK_TRUE(lsa.m_Size < 1024);
+
+            text.Destroy();
+            lsa.Destroy();
+            lma.Destroy();
+        }
+
+        // Parse with allocators that have exactly the measured capacity
+        static bool ParseMeasured(alloc_t* allocator, const char* json, const char* end, njson::JsonParseOptions const& options, njson::JsonParseSize& size)
+        {
+            njson::JsonAllocator lsa;
+            lsa.Init(allocator, 64 * 1024, "json_measure");
+            const char* errmsg = nullptr;
+            bool const  ok     = njson::Measure(json, end, &lsa, options, size, errmsg);
+            lsa.Destroy();
+            if (!ok)
+                return false;
+
+            njson::JsonAllocator lma;
+            lma.Init(allocator, size.m_AllocatorSize, "json_main");
+            lsa.Init(allocator, size.m_ScratchSize, "json_scratch");
+            njson::JsonValue const* root = njson::Parse(json, end, &lma, &lsa, options, errmsg);
+            bool const              fits = root != nullptr && errmsg == nullptr && lma.m_Size <= size.m_AllocatorSize;
+            lsa.Destroy();
+            lma.Destroy();
+            return fits;
+        }
+
+        UNITTEST_TEST(measure)
+        {
+            const char* json = "{ \"a\": [ 1, 2, \"x\" ], \"b\": { \"c\": null, \"d\": [ [], {} ] } }";
+            const char* end  = json + ascii::strlen(json);
+
+            njson::JsonParseOptions options;
+            njson::JsonParseSize    size;
+            CHECK_TRUE(ParseMeasured(Allocator, json, end, options, size));
+            CHECK_EQUAL(3, size.m_NumberOfObjects);
+            CHECK_EQUAL(3, size.m_NumberOfArrays);
+            CHECK_EQUAL(2, size.m_NumberOfNumbers);
+            CHECK_EQUAL(1, size.m_NumberOfStrings);
+            CHECK_EQUAL(4, size.m_NumberOfNames);
+            CHECK_EQUAL(10, (s32)size.m_StringBytes);
+
+            // Borrowed strings without escapes are not copied
+            options.m_Flags = njson::kJsonParseBorrowStrings;
+            CHECK_TRUE(ParseMeasured(Allocator, json, end, options, size));
+            CHECK_EQUAL(0, (s32)size.m_StringBytes);
+
+            json = (const char*)data_kyria;
+            end  = json + data_kyria_len;
+            const u32 flags[] = {njson::kJsonParseDefault, njson::kJsonParseBorrowStrings, njson::kJsonParseLazyNumbers, njson::kJsonParseIndexObjects | njson::kJsonParseValidateUtf8};
+            for (s32 i = 0; i < 4; ++i)
+            {
+                options.m_Flags = flags[i];
+                CHECK_TRUE(ParseMeasured(Allocator, json, end, options, size));
+            }
+
+            // Nested deeper than before after a container was closed, the frames are allocated again
+            json            = "[ [ [ [ 1 ] ] ], [ [ [ [ [ 2 ] ] ] ] ], \"s\" ]";
+            end             = json + ascii::strlen(json);
+            options.m_Flags = njson::kJsonParseDefault;
+            CHECK_TRUE(ParseMeasured(Allocator, json, end, options, size));
+        }
+
+        UNITTEST_TEST(measure_escapes)
+        {
+            // The string needs room for its escaped form before it is unescaped, that is more than what remains allocated
+            njson::JsonAllocator text;
+            text.Init(Allocator, 4096, "json_text");
+            char* json = text.AllocateArray<char>(1024);
+            char* end  = json;
+            *end++     = '"';
+            for (s32 i = 0; i < 100; ++i)
+            {
+                nmem::memcpy(end, "\\u0041", 6);
+                end += 6;
+            }
+            *end++ = '"';
+
+            njson::JsonAllocator lsa;
+            lsa.Init(Allocator, 64 * 1024, "json_scratch");
+
+            njson::JsonParseSize size;
+            const char*          errmsg = nullptr;
+            CHECK_TRUE(njson::Measure(json, end, &lsa, size, errmsg));
+            CHECK_NULL(errmsg);
+            CHECK_EQUAL(0, (s32)lsa.m_Size);
+            CHECK_EQUAL(101, (s32)size.m_StringBytes);
+
+            njson::JsonAllocator lma;
+            lma.Init(Allocator, size.m_AllocatorSize, "json_main");
+            njson::JsonValue const* root = njson::Parse(json, end, &lma, &lsa, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_EQUAL(100, (s32)(root->m_Value.m_String.m_End - root->m_Value.m_String.m_String));
+            lma.Destroy();
+
+            lma.Init(Allocator, size.m_AllocatorSize - 1, "json_main");
+            lsa.Reset();
+            root = njson::Parse(json, end, &lma, &lsa, errmsg);
+            CHECK_NULL(root);
+            CHECK_NOT_NULL(errmsg);
+            lma.Destroy();
+
+            // Errors are found while measuring
+            const char* invalid[] = {"[ \"\\q\" ]", "{ \"a\" 1 }", "[ 1 2 ]", "[ 1 ] 2", "{ \"a\": [ 1 } }"};
+            for (s32 i = 0; i < 5; ++i)
+            {
+                lsa.Reset();
+                errmsg = nullptr;
+                CHECK_FALSE(njson::Measure(invalid[i], invalid[i] + ascii::strlen(invalid[i]), &lsa, size, errmsg));
+                CHECK_NOT_NULL(errmsg);
+            }
+
+            lsa.Destroy();
+            text.Destroy();
+        }
+
+        UNITTEST_TEST(parse_exact)
+        {
+            const char* json = (const char*)data_kyria;
+            const char* end  = json + data_kyria_len;
+
+            njson::JsonAllocator lsa;
+            lsa.Init(Allocator, 64 * 1024, "json_scratch");
+
+            njson::JsonParseOptions options;
+            njson::JsonAllocator    document;
+            const char*             errmsg = nullptr;
+            njson::JsonValue const* root   = njson::ParseExact(json, end, Allocator, &document, &lsa, options, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_NOT_NULL(root);
+            CHECK_EQUAL(document.m_Capacity, document.m_Size);
+            CHECK_TRUE(StrEqual(root->Find("keyboard")->Find("name"), "Kyria"));
+            document.Destroy();
+
+            document.m_Pointer = nullptr;
+            root               = njson::ParseExact("[ 1, ]", "[ 1, ]" + 6, Allocator, &document, &lsa, options, errmsg);
+            CHECK_NULL(root);
+            CHECK_NOT_NULL(errmsg);
+            CHECK_NULL(document.m_Pointer);
+            lsa.Destroy();
+
+            // A scratch without room to unescape the string is an error, not an assert, and 'document' is left alone
+            njson::JsonAllocator text;
+            text.Init(Allocator, 8192, "json_text");
+            char* str = text.AllocateArray<char>(8192);
+            str[0]    = '[';
+            str[1]    = '"';
+            nmem::memset(str + 2, 'x', 8000);
+            str[2]    = '\\';
+            str[3]    = 'n';
+            str[8002] = '"';
+            str[8003] = ']';
+
+            lsa.Init(Allocator, 4096, "json_scratch");
+            errmsg = nullptr;
+            root   = njson::ParseExact(str, str + 8004, Allocator, &document, &lsa, options, errmsg);
+            CHECK_NULL(root);
+            CHECK_NOT_NULL(errmsg);
+            CHECK_NULL(document.m_Pointer);
+
+            lsa.Destroy();
+            text.Destroy();
+        }
     }
 }
 UNITTEST_SUITE_END
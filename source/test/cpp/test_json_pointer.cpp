@@ -0,0 +1,131 @@
+#include "ccore/c_target.h"
+#include "cbase/c_memory.h"
+#include "cbase/c_runes.h"
+#include "cjson/c_json_parser.h"
+#include "cjson/c_json_scanner.h"
+#include "cjson/c_json_tape.h"
+#include "cjson/c_json_allocator.h"
+#include "cjson/c_json_pointer.h"
+
+#include "cunittest/cunittest.h"
+
+using namespace ncore;
+
+extern unsigned char data_kyria[];
+extern unsigned int  data_kyria_len;
+
+UNITTEST_SUITE_BEGIN(json_pointer)
+{
+    UNITTEST_FIXTURE(pointer)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_ALLOCATOR;
+
+        UNITTEST_TEST(compile)
+        {
+            njson::JsonAllocator lma;
+            lma.Init(Allocator, 4096, "json_pointer");
+
+            const char*               errmsg  = nullptr;
+            njson::JsonPointer const* pointer = njson::CompilePointer("", &lma, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_EQUAL(0, pointer->m_Count);
+
+            pointer = njson::CompilePointer("/a~1b/m~0n/0/01/-/", &lma, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_EQUAL(6, pointer->m_Count);
+            CHECK_EQUAL("a/b", pointer->m_Steps[0].m_Key);
+            CHECK_EQUAL(3, pointer->m_Steps[0].m_KeyLen);
+            CHECK_EQUAL("m~n", pointer->m_Steps[1].m_Key);
+            CHECK_EQUAL(-1, pointer->m_Steps[1].m_Index);
+            CHECK_EQUAL(0, pointer->m_Steps[2].m_Index);
+            CHECK_EQUAL(-1, pointer->m_Steps[3].m_Index);
+            CHECK_EQUAL(-1, pointer->m_Steps[4].m_Index);
+            CHECK_EQUAL(0, pointer->m_Steps[5].m_KeyLen);
+            CHECK_TRUE(pointer->m_Steps[2].m_Hash == njson::JsonHashName("0", "0" + 1));
+
+            CHECK_NULL(njson::CompilePointer("a/b", &lma, errmsg));
+            CHECK_NOT_NULL(errmsg);
+            CHECK_NULL(njson::CompilePointer("/a~2", &lma, errmsg));
+            CHECK_NOT_NULL(errmsg);
+            CHECK_NULL(njson::CompilePointer("/a~", &lma, errmsg));
+            CHECK_NOT_NULL(errmsg);
+
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(resolve)
+        {
+            const char* json     = (const char*)data_kyria;
+            const char* json_end = json + data_kyria_len;
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            njson::JsonAllocator strs;
+            njson::JsonAllocator paths;
+            lma.Init(Allocator, 256 * 1024, "json_main");
+            lsa.Init(Allocator, 64 * 1024, "json_scratch");
+            strs.Init(Allocator, 16 * 1024, "json_strings");
+            paths.Init(Allocator, 4096, "json_pointer");
+
+            const char*               errmsg;
+            njson::JsonPointer const* label   = njson::CompilePointer("/keyboard/keygroups/0/keys/1/label", &paths, errmsg);
+            njson::JsonPointer const* color   = njson::CompilePointer("/keyboard/cap_color/3", &paths, errmsg);
+            njson::JsonPointer const* missing = njson::CompilePointer("/keyboard/cap_color/4", &paths, errmsg);
+            njson::JsonPointer const* member  = njson::CompilePointer("/keyboard/name/0", &paths, errmsg);
+            njson::JsonPointer const* root    = njson::CompilePointer("", &paths, errmsg);
+            CHECK_NULL(errmsg);
+
+            // The same pointers on every kind of document, resolving does not allocate
+            njson::JsonValue const* doc  = njson::Parse(json, json_end, &lma, &lsa, errmsg);
+            s64 const               size = lma.m_Size;
+            CHECK_EQUAL("Q", njson::Resolve(label, doc)->GetString());
+            CHECK_EQUAL(255, njson::Resolve(color, doc)->GetInt64());
+            CHECK_NULL(njson::Resolve(missing, doc));
+            CHECK_NULL(njson::Resolve(member, doc));
+            CHECK_TRUE(njson::Resolve(root, doc) == doc);
+            CHECK_EQUAL(size, lma.m_Size);
+
+            njson::nscanner::JsonValue const* scanned = njson::nscanner::Scan(json, json_end, &lma, errmsg);
+            njson::nscanner::JsonValue const* value   = njson::Resolve(label, scanned);
+            CHECK_EQUAL(1, (s32)(value->m_Value.m_String.m_End - value->m_Value.m_String.m_String));
+            CHECK_EQUAL('Q', value->m_Value.m_String.m_String[0]);
+            CHECK_EQUAL('2', njson::Resolve(color, scanned)->m_Value.m_Number.m_String[0]);
+            CHECK_NULL(njson::Resolve(missing, scanned));
+            CHECK_NULL(njson::Resolve(member, scanned));
+
+            njson::nscanner::JsonValue const* lazy = njson::nscanner::ScanLazy(json, json_end, &lma, errmsg);
+            CHECK_EQUAL('Q', njson::Resolve(label, lazy)->m_Value.m_String.m_String[0]);
+
+            njson::JsonTape const* tape = njson::ParseTape(json, json_end, &lma, &strs, &lsa, errmsg);
+            CHECK_EQUAL("Q", njson::Resolve(label, tape->Root()).GetString());
+            CHECK_EQUAL(255, njson::Resolve(color, tape->Root()).GetInt64());
+            CHECK_FALSE(njson::Resolve(missing, tape->Root()).IsValid());
+            CHECK_FALSE(njson::Resolve(member, tape->Root()).IsValid());
+
+            // Escaped keys
+            json                              = "{ \"a/b\": { \"m~n\": [ 7 ] }, \"\": 1 }";
+            doc                               = njson::Parse(json, json + ascii::strlen(json), &lma, &lsa, errmsg);
+            njson::JsonPointer const* escaped = njson::CompilePointer("/a~1b/m~0n/0", &paths, errmsg);
+            njson::JsonPointer const* empty   = njson::CompilePointer("/", &paths, errmsg);
+            CHECK_EQUAL(7, njson::Resolve(escaped, doc)->GetInt64());
+            CHECK_EQUAL(1, njson::Resolve(empty, doc)->GetInt64());
+
+            // A duplicate name resolves to the last member on every kind of document
+            json                                = "{ \"d\": 1, \"x\": 0, \"d\": 2 }";
+            json_end                            = json + ascii::strlen(json);
+            njson::JsonPointer const* duplicate = njson::CompilePointer("/d", &paths, errmsg);
+            CHECK_EQUAL(2, njson::Resolve(duplicate, njson::Parse(json, json_end, &lma, &lsa, errmsg))->GetInt64());
+            CHECK_EQUAL('2', njson::Resolve(duplicate, njson::nscanner::Scan(json, json_end, &lma, errmsg))->m_Value.m_Number.m_String[0]);
+            CHECK_EQUAL(2, njson::Resolve(duplicate, njson::ParseTape(json, json_end, &lma, &strs, &lsa, errmsg)->Root()).GetInt64());
+
+            paths.Destroy();
+            strs.Destroy();
+            lsa.Destroy();
+            lma.Destroy();
+        }
+    }
+}
+UNITTEST_SUITE_END
@@ -1,4 +1,5 @@
 #include "ccore/c_target.h"
+#include "cbase/c_memory.h"
 #include "cbase/c_runes.h"
 #include "cjson/c_json_scanner.h"
 #include "cjson/c_json_allocator.h"
@@ -32,6 +33,159 @@ UNITTEST_SUITE_BEGIN(json_scanner)
             CHECK_NULL(errmsg);
             CHECK_TRUE(root->m_Type == njson::nscanner::JsonValue::kObject);
 
+            njson::nscanner::JsonValue const* keyboard = root->Find("keyboard");
+            CHECK_NOT_NULL(keyboard);
+            njson::nscanner::JsonValue const* name = keyboard->Find("name");
+            CHECK_NOT_NULL(name);
+            CHECK_EQUAL(5, (s32)(name->m_Value.m_String.m_End - name->m_Value.m_String.m_String));
+            CHECK_NOT_NULL(keyboard->Find("key_spacing_xyz", 13));
+            CHECK_NULL(keyboard->Find("key_spacing"));
+            CHECK_NULL(root->Find("name"));
+
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(max_depth)
+        {
+            const char* json = "{ \"a\": [ [ { \"b\": [ 1, 2 ] } ] ], \"c\": true }";
+            const char* end  = json + ascii::strlen(json);
+
+            njson::JsonAllocator lma;
+            lma.Init(Allocator, 16384, "json_main");
+
+            const char*                       errmsg;
+            njson::nscanner::JsonValue const* root = njson::nscanner::Scan(json, end, &lma, 5, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_TRUE(root->m_Type == njson::nscanner::JsonValue::kObject);
+
+            root = njson::nscanner::Scan(json, end, &lma, 4, errmsg);
+            CHECK_NULL(root);
+            CHECK_NOT_NULL(errmsg);
+
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(lazy)
+        {
+            const char* json     = (const char*)data_kyria;
+            const char* json_end = json + data_kyria_len;
+
+            njson::JsonAllocator lma;
+            lma.Init(Allocator, 16384, "json_main");
+
+            const char*                       errmsg;
+            njson::nscanner::JsonValue const* root = njson::nscanner::Scan(json, json_end, &lma, errmsg);
+            CHECK_NULL(errmsg);
+            s64 const eager_size = lma.m_Size;
+            lma.Reset();
+
+            root = njson::nscanner::ScanLazy(json, json_end, &lma, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_TRUE(root->IsObject());
+            CHECK_TRUE(root->IsLazy());
+            CHECK_EQUAL(njson::nscanner::kJsonLazyCount, root->m_Value.m_Object.m_Count);
+
+            // Only the containers on the path are expanded
+            njson::nscanner::JsonValue const* keyboard = root->Find("keyboard");
+            CHECK_FALSE(root->IsLazy());
+            CHECK_TRUE(keyboard->IsLazy());
+            njson::nscanner::JsonValue const* name = keyboard->Find("name");
+            CHECK_EQUAL(5, (s32)(name->m_Value.m_String.m_End - name->m_Value.m_String.m_String));
+            CHECK_TRUE(lma.m_Size < eager_size / 2);
+
+            njson::nscanner::JsonValue const* cap_color = keyboard->Find("cap_color");
+            CHECK_TRUE(cap_color->IsLazy());
+            CHECK_EQUAL('[', *cap_color->m_Value.m_Lazy.m_Span->m_Begin);
+            CHECK_EQUAL(']', cap_color->m_Value.m_Lazy.m_Span->m_End[-1]);
+            i32 count = 0;
+            cap_color->ArrayHead(count);
+            CHECK_EQUAL(4, count);
+
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(lazy_skip)
+        {
+            njson::JsonAllocator lma;
+            lma.Init(Allocator, 256 * 1024, "json_main");
+
+            // Brackets inside strings are not counted
+            const char*                       json = "{ \"a\": \"]}\", \"b\": [ \"[\", { \"c\": \"\\\"]\" } ], \"d\": [] }";
+            const char*                       errmsg;
+            njson::nscanner::JsonValue const* root = njson::nscanner::ScanLazy(json, json + ascii::strlen(json), &lma, errmsg);
+            CHECK_NULL(errmsg);
+            i32 count = 0;
+            CHECK_NOT_NULL(root->MemberHead(count));
+            CHECK_EQUAL(3, count);
+            njson::nscanner::JsonValue const* b = root->Find("b");
+            CHECK_NOT_NULL(b->ArrayHead(count));
+            CHECK_EQUAL(2, count);
+            CHECK_NOT_NULL(b->m_Value.m_Array.m_LinkedList->m_Next->m_Value->Find("c"));
+            root->Find("d")->ArrayHead(count);
+            CHECK_EQUAL(0, count);
+
+            // The content of a container is checked when it is expanded
+            json = "{ \"a\": 1, \"b\": [ 1 2 ] }";
+            root = njson::nscanner::ScanLazy(json, json + ascii::strlen(json), &lma, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_NOT_NULL(root->Find("a"));
+            b = root->Find("b");
+            errmsg = b->Expand();
+            CHECK_NOT_NULL(errmsg);
+            CHECK_TRUE(b->IsError());
+            CHECK_FALSE(b->IsLazy());
+            CHECK_NULL(b->ArrayHead(count));
+            CHECK_EQUAL(0, count);
+            CHECK_EQUAL(errmsg, b->Expand());
+
+            // The error is reported at its position in the document, not in the text of the container
+            json = "{ \"a\": 1,\n  \"b\": [ 1 2 ] }";
+            root = njson::nscanner::ScanLazy(json, json + ascii::strlen(json), &lma, errmsg);
+            CHECK_NULL(errmsg);
+            errmsg = root->Find("b")->Expand();
+            CHECK_EQUAL("line 2, column 13: expected ','", (const char*)errmsg);
+
+            // An expanded container shares the null value of its document
+            json = "{ \"a\": null, \"b\": [ null ] }";
+            root = njson::nscanner::ScanLazy(json, json + ascii::strlen(json), &lma, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_EQUAL(root->Find("a"), root->Find("b")->ArrayHead(count)->m_Value);
+
+            // A nested container with invalid text is found in error through Find, it does not look empty
+            json = "{ \"a\": { \"b\": { \"c\": 1 \"d\": 2 }, \"e\": [] } }";
+            root = njson::nscanner::ScanLazy(json, json + ascii::strlen(json), &lma, errmsg);
+            CHECK_NULL(errmsg);
+            njson::nscanner::JsonValue const* nested = root->Find("a")->Find("b");
+            CHECK_TRUE(nested->IsLazy());
+            CHECK_NULL(nested->Find("c"));
+            CHECK_TRUE(nested->IsError());
+            CHECK_NOT_NULL(nested->Expand());
+            CHECK_NULL(nested->MemberHead(count));
+            CHECK_EQUAL(0, count);
+            CHECK_FALSE(root->Find("a")->Find("e")->IsError());
+
+            // A container that is not closed is an error
+            json = "{ \"a\": [ [ 1 ] }";
+            root = njson::nscanner::ScanLazy(json, json + ascii::strlen(json), &lma, errmsg);
+            CHECK_NULL(root);
+            CHECK_NOT_NULL(errmsg);
+
+            // Skipped containers need no frames, nesting is not limited
+            s32 const depth = 10000;
+            char*     deep  = lma.AllocateArray<char>(2 * depth + 16);
+            char*     end   = deep;
+            nmem::memcpy(end, "[ 1, ", 5);
+            end += 5;
+            for (s32 i = 0; i < depth; ++i)
+                *end++ = '[';
+            for (s32 i = 0; i < depth; ++i)
+                *end++ = ']';
+            *end++ = ']';
+            root   = njson::nscanner::ScanLazy(deep, end, &lma, errmsg);
+            CHECK_NULL(errmsg);
+            root->ArrayHead(count);
+            CHECK_EQUAL(2, count);
+
             lma.Destroy();
         }
     }
@@ -0,0 +1,147 @@
+#include "ccore/c_target.h"
+#include "cbase/c_memory.h"
+#include "cbase/c_runes.h"
+#include "cjson/c_json_parser.h"
+#include "cjson/c_json_allocator.h"
+#include "cjson/c_json_string_pool.h"
+
+#include "cunittest/cunittest.h"
+
+using namespace ncore;
+
+extern unsigned char data_kyria[];
+extern unsigned int  data_kyria_len;
+
+UNITTEST_SUITE_BEGIN(json_string_pool)
+{
+    UNITTEST_FIXTURE(pool)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_ALLOCATOR;
+
+        UNITTEST_TEST(intern)
+        {
+            njson::JsonStringPool pool;
+            pool.Init(Allocator, 4, 256, "json_keys");
+
+            const char* text = "name name\0x";
+            const char* a    = pool.Intern(text, text + 4);
+            const char* b    = pool.Intern(text + 5, text + 9);
+            CHECK_NOT_NULL(a);
+            CHECK_TRUE(a == b);
+            CHECK_TRUE(a != text);
+            CHECK_EQUAL("name", a);
+            CHECK_EQUAL(4, njson::JsonStringPool::Length(a));
+            CHECK_EQUAL(1, pool.m_Count);
+
+            // An embedded NUL is part of the string
+            const char* c = pool.Intern(text + 5, text + 11);
+            CHECK_TRUE(c != a);
+            CHECK_EQUAL(6, njson::JsonStringPool::Length(c));
+            CHECK_TRUE(pool.Find(text + 5, text + 11) == c);
+            CHECK_TRUE(pool.Find(text, text + 3) == nullptr);
+
+            // The empty string
+            const char* e = pool.Intern(text, text);
+            CHECK_NOT_NULL(e);
+            CHECK_EQUAL(0, njson::JsonStringPool::Length(e));
+            CHECK_TRUE(pool.Intern(text + 4, text + 4) == e);
+
+            // Full, strings that are in the pool are still found
+            CHECK_NOT_NULL(pool.Intern(text, text + 1));
+            CHECK_NULL(pool.Intern(text, text + 2));
+            CHECK_TRUE(pool.Intern(text, text + 4) == a);
+
+            pool.Reset();
+            CHECK_EQUAL(0, pool.m_Count);
+            CHECK_NULL(pool.Find(text, text + 4));
+
+            pool.Destroy();
+        }
+
+        UNITTEST_TEST(parse)
+        {
+            const char* json     = (const char*)data_kyria;
+            const char* json_end = json + data_kyria_len;
+
+            njson::JsonStringPool pool;
+            pool.Init(Allocator, 1024, 64 * 1024, "json_keys");
+
+            // Pre-warmed
+            const char* name = pool.Intern("name", "name" + 4);
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 256 * 1024, "json_main");
+            lsa.Init(Allocator, 64 * 1024, "json_scratch");
+
+            njson::JsonParseOptions options;
+            const char*             errmsg = nullptr;
+            njson::JsonValue const* plain  = njson::Parse(json, json_end, &lma, &lsa, options, errmsg);
+            CHECK_NULL(errmsg);
+            s64 const plain_size = lma.m_Size;
+
+            // The same document twice, the second time all names are already in the pool
+            options.m_KeyPool                = &pool;
+            njson::JsonValue const* first    = njson::Parse(json, json_end, &lma, &lsa, options, errmsg);
+            CHECK_NULL(errmsg);
+            s64 const               used     = lma.m_Size - plain_size;
+            s32 const               count    = pool.m_Count;
+            njson::JsonValue const* second   = njson::Parse(json, json_end, &lma, &lsa, options, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_EQUAL(count, pool.m_Count);
+            CHECK_TRUE(used < plain_size);
+            CHECK_EQUAL(used, lma.m_Size - plain_size - used);
+
+            njson::JsonValue const* keyboard = first->Find("keyboard");
+            CHECK_TRUE(keyboard->m_Value.m_Object.m_Members[0].m_Name == second->Find("keyboard")->m_Value.m_Object.m_Members[0].m_Name);
+            CHECK_TRUE(keyboard->FindPooled(name) == keyboard->Find("name"));
+            CHECK_TRUE(keyboard->FindPooled("name") == nullptr);
+            CHECK_TRUE(plain->Find("keyboard")->Find("name")->m_Value.m_String.m_String != nullptr);
+            CHECK_EQUAL("Kyria", keyboard->Find("name")->m_Value.m_String.m_String);
+
+            // A pool that is too small, names that do not fit are allocated as usual
+            njson::JsonStringPool small;
+            small.Init(Allocator, 2, 256, "json_keys_small");
+            options.m_KeyPool            = &small;
+            njson::JsonValue const* root = njson::Parse(json, json_end, &lma, &lsa, options, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_EQUAL(2, small.m_Count);
+            CHECK_EQUAL("Kyria", root->Find("keyboard")->Find("name")->m_Value.m_String.m_String);
+
+            // Names are looked up in the pool before anything is copied, the length of a name does not matter
+            options.m_KeyPool = &pool;
+            char long_json[300];
+            nmem::memset(long_json, 'k', sizeof(long_json));
+            long_json[0] = '{';
+            long_json[1] = '"';
+            nmem::memcpy(long_json + sizeof(long_json) - 6, "\": 1 }", 6);
+
+            const char* short_json = "{ \"k\": 1 }";
+            s64 const   before     = lma.m_Size;
+            CHECK_NOT_NULL(njson::Parse(short_json, short_json + ascii::strlen(short_json), &lma, &lsa, options, errmsg));
+            s64 const short_used = lma.m_Size - before;
+            CHECK_NOT_NULL(njson::Parse(long_json, long_json + sizeof(long_json), &lma, &lsa, options, errmsg));
+            CHECK_EQUAL(short_used, lma.m_Size - before - short_used);
+
+            // An escaped name is interned unescaped, also when parsing in-situ
+            char escaped[] = "{ \"ke\\u0079\": [ \"x\" ] }";
+            root           = njson::ParseInSitu(escaped, escaped + ascii::strlen(escaped), &lma, &lsa, options, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_TRUE(root->m_Value.m_Object.m_Members[0].m_Name == pool.Find("key", "key" + 3));
+            CHECK_EQUAL("x", root->Find("key")->At(0)->GetString());
+
+            const char* bad = "{ \"a\\x\": 1 }";
+            CHECK_NULL(njson::Parse(bad, bad + ascii::strlen(bad), &lma, &lsa, options, errmsg));
+            CHECK_NOT_NULL(errmsg);
+
+            small.Destroy();
+            lsa.Destroy();
+            lma.Destroy();
+            pool.Destroy();
+        }
+    }
+}
+UNITTEST_SUITE_END
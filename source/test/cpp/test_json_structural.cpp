@@ -0,0 +1,113 @@
+#include "ccore/c_target.h"
+#include "cbase/c_runes.h"
+#include "cjson/c_json_structural.h"
+#include "cjson/c_json_scanner.h"
+#include "cjson/c_json_allocator.h"
+
+#include "cunittest/cunittest.h"
+
+using namespace ncore;
+
+extern unsigned char data_kyria[];
+extern unsigned int  data_kyria_len;
+
+UNITTEST_SUITE_BEGIN(json_structural)
+{
+    UNITTEST_FIXTURE(index)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_ALLOCATOR;
+
+        UNITTEST_TEST(classify_scalar_and_simd_are_identical)
+        {
+            const char* json = (const char*)data_kyria;
+            for (u32 i = 0; (i + 64) <= data_kyria_len; i += 64)
+            {
+                njson::JsonBlockClass simd, scalar;
+                njson::JsonClassifyBlock(json + i, simd);
+                njson::JsonClassifyBlockScalar(json + i, scalar);
+                CHECK_TRUE(simd.m_Quote == scalar.m_Quote);
+                CHECK_TRUE(simd.m_Backslash == scalar.m_Backslash);
+                CHECK_TRUE(simd.m_Operator == scalar.m_Operator);
+                CHECK_TRUE(simd.m_Whitespace == scalar.m_Whitespace);
+            }
+        }
+
+        UNITTEST_TEST(offsets)
+        {
+            const char* json = "{\"a\":[1, true,\"x,y\"]}";
+            u32         offsets[32];
+            s32 const   count = njson::JsonStructuralIndex(json, json + ascii::strlen(json), offsets, 32);
+
+            u32 const expected[] = {0, 1, 4, 5, 6, 7, 9, 13, 14, 19, 20};
+            CHECK_EQUAL(11, count);
+            for (s32 i = 0; i < count && i < 11; ++i)
+                CHECK_EQUAL(expected[i], offsets[i]);
+
+            CHECK_EQUAL(-1, njson::JsonStructuralIndex(json, json + ascii::strlen(json), offsets, 4));
+        }
+
+        UNITTEST_TEST(escapes)
+        {
+            const char* json = "[\"a\\\"b\",\"c\\\\\",1]";
+            u32         offsets[32];
+            s32 const   count = njson::JsonStructuralIndex(json, json + ascii::strlen(json), offsets, 32);
+
+            u32 const expected[] = {0, 1, 7, 8, 13, 14, 15};
+            CHECK_EQUAL(7, count);
+            for (s32 i = 0; i < count && i < 7; ++i)
+                CHECK_EQUAL(expected[i], offsets[i]);
+        }
+
+        UNITTEST_TEST(string_across_blocks)
+        {
+            // A string that contains structural characters and crosses the 64-byte block boundary
+            char json[256];
+            s32  len    = 0;
+            json[len++] = '[';
+            json[len++] = '"';
+            for (s32 i = 0; i < 100; ++i)
+                json[len++] = (i % 10 == 0) ? '\\' : ((i % 3 == 0) ? ',' : 'a');
+            json[len++] = '"';
+            json[len++] = ',';
+            json[len++] = '2';
+            json[len++] = ']';
+            json[len]   = '\0';
+
+            njson::JsonAllocator lma;
+            lma.Init(Allocator, 8192, "json_main");
+
+            const char*                       errmsg;
+            njson::nscanner::JsonValue const* root = njson::nscanner::Scan(json, json + len, &lma, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_TRUE(root != nullptr && root->IsArray());
+
+            i32                                     count = 0;
+            njson::nscanner::JsonLinkedValue const* item  = root->ArrayHead(count);
+            CHECK_EQUAL(2, count);
+            CHECK_TRUE(item->m_Value->IsString());
+            CHECK_EQUAL(100, (s32)(item->m_Value->m_Value.m_String.m_End - item->m_Value->m_Value.m_String.m_String));
+            CHECK_TRUE(item->m_Next->m_Value->IsNumber());
+
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(unterminated_string)
+        {
+            const char* json = "{\n\"name\": \"value }";
+
+            njson::JsonAllocator lma;
+            lma.Init(Allocator, 8192, "json_main");
+
+            const char*                       errmsg;
+            njson::nscanner::JsonValue const* root = njson::nscanner::Scan(json, json + ascii::strlen(json), &lma, errmsg);
+            CHECK_NULL(root);
+            CHECK_TRUE(errmsg != nullptr);
+
+            lma.Destroy();
+        }
+    }
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,172 @@
+#include "ccore/c_target.h"
+#include "cbase/c_memory.h"
+#include "cbase/c_runes.h"
+#include "cjson/c_json_parser.h"
+#include "cjson/c_json_allocator.h"
+#include "cjson/c_json_tape.h"
+
+#include "cunittest/cunittest.h"
+
+using namespace ncore;
+
+extern unsigned char data_kyria[];
+extern unsigned int  data_kyria_len;
+
+static bool StrEqual(njson::JsonTapeValue const& value, const char* b)
+{
+    s32 const len = ascii::strlen(b);
+    return value.GetStringLength() == len && nmem::memcmp(value.GetString(), b, len) == 0;
+}
+
+UNITTEST_SUITE_BEGIN(json_tape)
+{
+    UNITTEST_FIXTURE(parse)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_ALLOCATOR;
+
+        UNITTEST_TEST(test)
+        {
+            const char* json     = (const char*)data_kyria;
+            const char* json_end = json + data_kyria_len;
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            njson::JsonAllocator strs;
+            lma.Init(Allocator, 64 * 1024, "json_tape");
+            strs.Init(Allocator, 16 * 1024, "json_strings");
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            const char*            errmsg;
+            njson::JsonTape const* tape = njson::ParseTape(json, json_end, &lma, &strs, &lsa, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_NOT_NULL(tape);
+
+            njson::JsonTapeValue const root = tape->Root();
+            CHECK_TRUE(root.IsObject());
+            CHECK_TRUE(root.Next().m_Index == tape->m_Count);
+
+            njson::JsonTapeValue const keyboard = root.Find("keyboard");
+            CHECK_TRUE(keyboard.IsObject());
+            CHECK_TRUE(StrEqual(keyboard.Find("name"), "Kyria"));
+            CHECK_EQUAL(0.125, keyboard.Find("key_spacing_x").GetNumber());
+            CHECK_EQUAL(42, keyboard.Find("scale").GetInt64());
+
+            njson::JsonTapeValue const cap_color = keyboard.Find("cap_color");
+            CHECK_EQUAL(4, cap_color.Count());
+            CHECK_EQUAL(255, cap_color.At(3).GetInt64());
+            CHECK_FALSE(cap_color.At(4).IsValid());
+
+            // The words are given back, only what the tape uses is allocated
+            CHECK_TRUE(lma.m_Size <= (s64)(sizeof(njson::JsonTape) + sizeof(u64) * (tape->m_Count + 1)));
+
+            strs.Destroy();
+            lsa.Destroy();
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(layout)
+        {
+            const char* json = "{ \"a\": [ 1, -2, 3.5, 18446744073709551615 ], \"b\\u0000c\": \"x\\ty\", \"t\": true, \"n\": null, \"e\": {} }";
+            const char* end  = json + ascii::strlen(json);
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            njson::JsonAllocator strs;
+            lma.Init(Allocator, 4096, "json_tape");
+            strs.Init(Allocator, 4096, "json_strings");
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            const char*            errmsg;
+            njson::JsonTape const* tape = njson::ParseTape(json, end, &lma, &strs, &lsa, errmsg);
+            CHECK_NULL(errmsg);
+
+            // { "a" [ l 1 l -2 d 3.5 u max ] "b\0c" "x\ty" "t" t "n" n "e" { } }
+            CHECK_EQUAL(22, tape->m_Count);
+            CHECK_EQUAL(njson::kJsonTapeObject, (s32)(tape->m_Words[0] >> 56));
+            CHECK_EQUAL(21, (s32)(u32)tape->m_Words[0]);
+            CHECK_EQUAL(5, (s32)((tape->m_Words[0] >> 32) & njson::kJsonTapeCountMax));
+            CHECK_EQUAL(njson::kJsonTapeObjectEnd, (s32)(tape->m_Words[21] >> 56));
+            CHECK_EQUAL(0, (s32)(u32)tape->m_Words[21]);
+
+            njson::JsonTapeValue const root = tape->Root();
+            njson::JsonTapeValue const a    = root.Find("a");
+            CHECK_TRUE(a.IsArray());
+            CHECK_EQUAL(4, a.Count());
+            CHECK_EQUAL(1, a.At(0).GetInt64());
+            CHECK_EQUAL(-2, a.At(1).GetInt64());
+            CHECK_EQUAL(3.5, a.At(2).GetNumber());
+            CHECK_TRUE(a.At(3).GetUInt64() == 18446744073709551615ull);
+
+            // Names and strings are unescaped, the length includes an embedded NUL
+            njson::JsonTapeValue const bc = root.Find("b\0c", 3);
+            CHECK_TRUE(bc.IsString());
+            CHECK_TRUE(StrEqual(bc, "x\ty"));
+            CHECK_FALSE(root.Find("b").IsValid());
+
+            CHECK_TRUE(root.Find("t").GetBoolean());
+            CHECK_TRUE(root.Find("n").IsNull());
+            CHECK_EQUAL(0, root.Find("e").Count());
+            CHECK_FALSE(root.Find("e").First().IsValid());
+
+            // Iterate the members in document order
+            const char* names[] = {"a", "b", "t", "n", "e"};
+            s32         i       = 0;
+            for (njson::JsonTapeValue name = root.First(); name.IsValid(); name = name.Next().Next())
+                CHECK_TRUE(name.GetString()[0] == names[i++][0]);
+            CHECK_EQUAL(5, i);
+
+            strs.Destroy();
+            lsa.Destroy();
+            lma.Destroy();
+        }
+
+        UNITTEST_TEST(errors)
+        {
+            const char* documents[] = {"[ 1, ]", "{ \"a\" 1 }", "[ 1 2 ]", "{ \"a\": }", "[ [ 1 ]", "[ 1 ] 2", "[ \"\\q\" ]"};
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            njson::JsonAllocator strs;
+            lma.Init(Allocator, 4096, "json_tape");
+            strs.Init(Allocator, 4096, "json_strings");
+            lsa.Init(Allocator, 32 * 1024, "json_scratch");
+
+            for (s32 i = 0; i < (s32)(sizeof(documents) / sizeof(documents[0])); ++i)
+            {
+                const char*            errmsg = nullptr;
+                njson::JsonTape const* tape   = njson::ParseTape(documents[i], documents[i] + ascii::strlen(documents[i]), &lma, &strs, &lsa, errmsg);
+                CHECK_NULL(tape);
+                CHECK_NOT_NULL(errmsg);
+            }
+
+            // A document that does not fit is an error, not a crash
+            const char*            json   = "[ 1, 2, 3, 4, 5, 6, 7, 8 ]";
+            njson::JsonAllocator   small;
+            const char*            errmsg = nullptr;
+            small.Init(Allocator, 64, "json_tape_small");
+            njson::JsonTape const* tape = njson::ParseTape(json, json + ascii::strlen(json), &small, &strs, &lsa, errmsg);
+            CHECK_NULL(tape);
+            CHECK_NOT_NULL(errmsg);
+
+            // Nesting deeper than the maximum depth is an error
+            njson::JsonParseOptions options;
+            options.m_MaxDepth = 2;
+            json               = "[ [ [ 1 ] ] ]";
+            tape               = njson::ParseTape(json, json + ascii::strlen(json), &lma, &strs, &lsa, options, errmsg);
+            CHECK_NULL(tape);
+            options.m_MaxDepth = 3;
+            tape               = njson::ParseTape(json, json + ascii::strlen(json), &lma, &strs, &lsa, options, errmsg);
+            CHECK_NOT_NULL(tape);
+            CHECK_EQUAL(1, tape->Root().At(0).At(0).At(0).GetInt64());
+
+            small.Destroy();
+            strs.Destroy();
+            lsa.Destroy();
+            lma.Destroy();
+        }
+    }
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,98 @@
+#include "ccore/c_target.h"
+#include "cbase/c_runes.h"
+#include "cjson/c_json_utf8.h"
+#include "cjson/c_json_parser.h"
+#include "cjson/c_json_allocator.h"
+
+#include "cunittest/cunittest.h"
+
+using namespace ncore;
+
+extern unsigned char data_kyria[];
+extern unsigned int  data_kyria_len;
+
+static bool IsValid(const char* str) { return njson::ValidateUtf8(str, str + ascii::strlen(str)); }
+
+UNITTEST_SUITE_BEGIN(json_utf8)
+{
+    UNITTEST_FIXTURE(validate)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_ALLOCATOR;
+
+        UNITTEST_TEST(valid)
+        {
+            CHECK_TRUE(IsValid(""));
+            CHECK_TRUE(IsValid("plain ascii"));
+            CHECK_TRUE(IsValid("h\xc3\xa9llo"));                 // U+00E9
+            CHECK_TRUE(IsValid("\xe2\x82\xac 100"));             // U+20AC
+            CHECK_TRUE(IsValid("\xf0\x9f\x98\x80"));             // U+1F600
+            CHECK_TRUE(IsValid("\xed\x9f\xbf"));                 // U+D7FF
+            CHECK_TRUE(IsValid("\xf4\x8f\xbf\xbf"));             // U+10FFFF
+            CHECK_TRUE(njson::ValidateUtf8((const char*)data_kyria, (const char*)data_kyria + data_kyria_len));
+        }
+
+        UNITTEST_TEST(invalid)
+        {
+            CHECK_FALSE(IsValid("\xc0\xaf"));         // overlong '/'
+            CHECK_FALSE(IsValid("\xe0\x80\xaf"));     // overlong
+            CHECK_FALSE(IsValid("\xf0\x80\x80\xaf")); // overlong
+            CHECK_FALSE(IsValid("\xed\xa0\x80"));     // surrogate U+D800
+            CHECK_FALSE(IsValid("\xf4\x90\x80\x80")); // U+110000
+            CHECK_FALSE(IsValid("\xf8\x88\x80\x80")); // 5 byte sequence
+            CHECK_FALSE(IsValid("\x80"));             // stray continuation
+            CHECK_FALSE(IsValid("\xc3"));             // truncated
+            CHECK_FALSE(IsValid("\xe2\x82"));         // truncated
+            CHECK_FALSE(IsValid("\xc3\x28"));         // missing continuation
+        }
+
+        UNITTEST_TEST(position)
+        {
+            // Move an invalid byte through a long ASCII text so that it lands on every offset of a vector
+            char text[80];
+            for (s32 i = 0; i < 80; ++i)
+            {
+                for (s32 j = 0; j < 80; ++j)
+                    text[j] = 'a' + (j % 26);
+                text[i] = (char)0xFF;
+                CHECK_TRUE(njson::FindInvalidUtf8(text, text + 80) == text + i);
+            }
+
+            // A sequence that is cut off by the end of the text
+            for (s32 j = 0; j < 80; ++j)
+                text[j] = 'a' + (j % 26);
+            text[78] = (char)0xE2;
+            text[79] = (char)0x82;
+            CHECK_TRUE(njson::FindInvalidUtf8(text, text + 80) == text + 78);
+        }
+
+        UNITTEST_TEST(parse)
+        {
+            const char* json = "{ \"name\": \"caf\xc3\xa9\", \"bad\": \"\xed\xa0\x80\" }";
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 16384, "json_main");
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            njson::JsonParseOptions options;
+            options.m_Flags = njson::kJsonParseValidateUtf8;
+
+            const char*             errmsg;
+            njson::JsonValue const* root = njson::Parse(json, json + ascii::strlen(json), &lma, &lsa, options, errmsg);
+            CHECK_NULL(root);
+            CHECK_TRUE(errmsg != nullptr);
+
+            // Without validation the document is accepted as is
+            root = njson::Parse(json, json + ascii::strlen(json), &lma, &lsa, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_TRUE(root != nullptr);
+
+            lsa.Destroy();
+            lma.Destroy();
+        }
+    }
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,256 @@
+#include "ccore/c_target.h"
+#include "cbase/c_memory.h"
+#include "cbase/c_runes.h"
+#include "cjson/c_json_parser.h"
+#include "cjson/c_json_allocator.h"
+#include "cjson/c_json_write.h"
+
+#include "cunittest/cunittest.h"
+
+using namespace ncore;
+
+extern unsigned char data_kyria[];
+extern unsigned int  data_kyria_len;
+
+struct JsonTestSink
+{
+    char* m_Text;
+    s32   m_Len;
+    s32   m_Cap;
+    s32   m_Flushes;
+};
+
+static bool JsonTestFlush(void* user, char const* str, s32 len)
+{
+    JsonTestSink* sink = (JsonTestSink*)user;
+    sink->m_Flushes += 1;
+    if (sink->m_Len + len > sink->m_Cap)
+        return false;
+    nmem::memcpy(sink->m_Text + sink->m_Len, str, len);
+    sink->m_Len += len;
+    return true;
+}
+
+UNITTEST_SUITE_BEGIN(json_write)
+{
+    UNITTEST_FIXTURE(write)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_ALLOCATOR;
+
+        UNITTEST_TEST(compact)
+        {
+            const char* json = "{ \"a\": [ 1, -2, 0.5, 18446744073709551615, true, false, null ], \"s\\t\": \"x\\\"y\\\\\\n\\u0001\", \"e\": {}, \"f\": [] }";
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 8192, "json_write");
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            const char*             errmsg = nullptr;
+            njson::JsonValue const* root   = njson::Parse(json, json + ascii::strlen(json), &lma, &lsa, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_NOT_NULL(root);
+
+            const char* expected = "{\"a\":[1,-2,0.5,18446744073709551615,true,false,null],\"s\\t\":\"x\\\"y\\\\\\n\\u0001\",\"e\":{},\"f\":[]}";
+            s32 const   len      = ascii::strlen(expected);
+
+            njson::JsonWriteOptions options;
+            CHECK_EQUAL(len, (s32)njson::WriteSize(root, options));
+
+            char  text[256];
+            char* end = njson::Write(root, text, text + len + 1, options);
+            CHECK_NOT_NULL(end);
+            CHECK_EQUAL(len, (s32)(end - text));
+            CHECK_EQUAL(expected, (const char*)text);
+
+            // One byte short, there is no room for the terminator
+            CHECK_NULL(njson::Write(root, text, text + len, options));
+
+            lma.Destroy();
+            lsa.Destroy();
+        }
+
+        UNITTEST_TEST(pretty)
+        {
+            const char* json = "{\"a\":[1,[]],\"b\":{\"c\":\"d\"},\"e\":{}}";
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 8192, "json_write");
+            lsa.Init(Allocator, 8192, "json_scratch");
+
+            const char*             errmsg = nullptr;
+            njson::JsonValue const* root   = njson::Parse(json, json + ascii::strlen(json), &lma, &lsa, errmsg);
+            CHECK_NOT_NULL(root);
+
+            njson::JsonWriteOptions options;
+            options.m_Flags        = njson::kJsonWritePretty;
+            options.m_IndentSpaces = 2;
+
+            const char* expected = "{\n  \"a\": [\n    1,\n    []\n  ],\n  \"b\": {\n    \"c\": \"d\"\n  },\n  \"e\": {}\n}";
+
+            char text[256];
+            CHECK_NOT_NULL(njson::Write(root, text, text + sizeof(text), options));
+            CHECK_EQUAL(expected, (const char*)text);
+            CHECK_EQUAL(ascii::strlen(expected), (s32)njson::WriteSize(root, options));
+
+            lma.Destroy();
+            lsa.Destroy();
+        }
+
+        UNITTEST_TEST(failures)
+        {
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 64 * 1024, "json_write");
+            lsa.Init(Allocator, 64 * 1024, "json_scratch");
+
+            njson::JsonParseOptions parse_options;
+            parse_options.m_Flags = njson::kJsonParseLazyNumbers;
+
+            // Lazy number text is only checked when it is converted, text that is not a number is not written as anything else
+            const char*             json   = "[ 1, 2x ]";
+            const char*             errmsg = nullptr;
+            njson::JsonValue const* root   = njson::Parse(json, json + ascii::strlen(json), &lma, &lsa, parse_options, errmsg);
+            CHECK_NOT_NULL(root);
+
+            njson::JsonWriteOptions options;
+            char                    text[256];
+            CHECK_EQUAL(-1, (s32)njson::WriteSize(root, options));
+            CHECK_NULL(njson::Write(root, text, text + sizeof(text), options));
+
+            // Nested deeper than the writer walks, the document is not written and there is no recursion to overflow.
+            // The innermost array is empty and needs no frame.
+            s32 const depth = njson::kJsonDefaultMaxDepth + 2;
+            char*     deep  = lma.AllocateArray<char>(2 * depth);
+            for (s32 i = 0; i < depth; ++i)
+            {
+                deep[i]                 = '[';
+                deep[2 * depth - 1 - i] = ']';
+            }
+            parse_options.m_Flags    = njson::kJsonParseDefault;
+            parse_options.m_MaxDepth = depth;
+            root                     = njson::Parse(deep, deep + 2 * depth, &lma, &lsa, parse_options, errmsg);
+            CHECK_NOT_NULL(root);
+            CHECK_EQUAL(-1, (s32)njson::WriteSize(root, options));
+            CHECK_NULL(njson::Write(root, text, text + sizeof(text), options));
+
+            // One level less is written
+            root = njson::Parse(deep + 1, deep + 2 * depth - 1, &lma, &lsa, parse_options, errmsg);
+            CHECK_NOT_NULL(root);
+            CHECK_EQUAL(2 * (depth - 1), (s32)njson::WriteSize(root, options));
+
+            // Deeper with the frames in scratch, which is given back
+            root = njson::Parse(deep, deep + 2 * depth, &lma, &lsa, parse_options, errmsg);
+            CHECK_NOT_NULL(root);
+            s64 const scratch_size = lsa.m_Size;
+            options.m_MaxDepth     = depth;
+            options.m_Scratch      = &lsa;
+            CHECK_EQUAL(2 * depth, (s32)njson::WriteSize(root, options));
+            CHECK_EQUAL(scratch_size, lsa.m_Size);
+            options.m_MaxDepth = depth - 2;
+            CHECK_EQUAL(-1, (s32)njson::WriteSize(root, options));
+
+            lma.Destroy();
+            lsa.Destroy();
+        }
+
+        UNITTEST_TEST(round_trip)
+        {
+            const char* json     = (const char*)data_kyria;
+            const char* json_end = json + data_kyria_len;
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 256 * 1024, "json_write");
+            lsa.Init(Allocator, 64 * 1024, "json_scratch");
+
+            njson::JsonParseOptions parse_options;
+            parse_options.m_Flags = njson::kJsonParseLazyNumbers;
+
+            const char*             errmsg = nullptr;
+            njson::JsonValue const* root   = njson::Parse(json, json_end, &lma, &lsa, parse_options, errmsg);
+            CHECK_NULL(errmsg);
+            CHECK_NOT_NULL(root);
+
+            for (s32 pretty = 0; pretty < 2; ++pretty)
+            {
+                njson::JsonWriteOptions options;
+                options.m_Flags = pretty ? njson::kJsonWritePretty : njson::kJsonWriteCompact;
+
+                s64 const size  = njson::WriteSize(root, options);
+                char*     text1 = (char*)lma.Allocate(size + 1, 1);
+                char*     end1  = njson::Write(root, text1, text1 + size + 1, options);
+                CHECK_NOT_NULL(end1);
+                CHECK_EQUAL(size, (s64)(end1 - text1));
+
+                // The written text parses to a document that writes the same text
+                njson::JsonValue const* copy = njson::Parse(text1, end1, &lma, &lsa, errmsg);
+                CHECK_NULL(errmsg);
+                CHECK_NOT_NULL(copy);
+                CHECK_EQUAL(42, copy->Find("keyboard")->Find("scale")->GetInt64());
+
+                char* text2 = (char*)lma.Allocate(size + 1, 1);
+                char* end2  = njson::Write(copy, text2, text2 + size + 1, options);
+                CHECK_NOT_NULL(end2);
+                CHECK_EQUAL(size, (s64)(end2 - text2));
+                CHECK_EQUAL(0, nmem::memcmp(text1, text2, (s32)size));
+            }
+
+            lma.Destroy();
+            lsa.Destroy();
+        }
+
+        UNITTEST_TEST(sink)
+        {
+            const char* json     = (const char*)data_kyria;
+            const char* json_end = json + data_kyria_len;
+
+            njson::JsonAllocator lma;
+            njson::JsonAllocator lsa;
+            lma.Init(Allocator, 256 * 1024, "json_write");
+            lsa.Init(Allocator, 64 * 1024, "json_scratch");
+
+            const char*             errmsg = nullptr;
+            njson::JsonValue const* root   = njson::Parse(json, json_end, &lma, &lsa, errmsg);
+            CHECK_NOT_NULL(root);
+
+            njson::JsonWriteOptions options;
+            options.m_Flags = njson::kJsonWritePretty;
+
+            s64 const size = njson::WriteSize(root, options);
+            char*     text = (char*)lma.Allocate(size + 1, 1);
+            CHECK_NOT_NULL(njson::Write(root, text, text + size + 1, options));
+
+            char         chunk[njson::kJsonWriteSinkMinSize];
+            JsonTestSink out;
+            out.m_Text    = (char*)lma.Allocate(size, 1);
+            out.m_Len     = 0;
+            out.m_Cap     = (s32)size;
+            out.m_Flushes = 0;
+
+            njson::JsonWriteSink sink;
+            sink.m_Buffer     = chunk;
+            sink.m_BufferSize = sizeof(chunk);
+            sink.m_Flush      = JsonTestFlush;
+            sink.m_User       = &out;
+
+            CHECK_TRUE(njson::Write(root, sink, options));
+            CHECK_EQUAL(size, (s64)out.m_Len);
+            CHECK_TRUE(out.m_Flushes > 1);
+            CHECK_EQUAL(0, nmem::memcmp(text, out.m_Text, (s32)size));
+
+            // A sink that runs out of room stops the write
+            out.m_Len = 0;
+            out.m_Cap = (s32)(size / 2);
+            CHECK_FALSE(njson::Write(root, sink, options));
+
+            lma.Destroy();
+            lsa.Destroy();
+        }
+    }
+}
+UNITTEST_SUITE_END